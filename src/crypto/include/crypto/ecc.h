@@ -15,4 +15,11 @@ namespace crypto::ecc {
 		scalar.set_bit(31 * 8 + 6, true);
 		return montgomery_curve(scalar, u_coordinate, 255);
 	}
+
+	/**
+	 * \brief ECDSA verification over NIST P-256 (FIPS 186-4, section 6.4.2).
+	 * \param public_key Uncompressed SEC 1 point.
+	 * \param r,s Big-endian integers of the signature.
+	 */
+	bool p256_verify(byte_string_view public_key, byte_string_view digest, byte_string_view r, byte_string_view s);
 }
@@ -0,0 +1,37 @@
+#pragma once
+#include "big_number.h"
+#include <functional>
+
+namespace crypto::rsa {
+
+	struct public_key {
+
+		big_unsigned modulus;
+
+		big_unsigned exponent;
+
+		/// Size of the modulus in octets, i.e. the length of signatures and encoded messages.
+		[[nodiscard]] std::size_t size() const;
+	};
+
+	using hash_function = std::function<byte_string(byte_string_view)>;
+
+	/**
+	 * \brief RSAVP1 (RFC 8017, section 5.2.2) by Montgomery exponentiation over 64-bit limbs.
+	 * \return The encoded message as a big-endian string of `key.size()` octets.
+	 */
+	byte_string verify_primitive(const public_key& key, byte_string_view signature);
+
+	/**
+	 * \brief RSASSA-PKCS1-v1_5 verification (RFC 8017, section 8.2.2).
+	 * \param digest_info DER encoding of the DigestInfo, i.e. the algorithm prefix followed by the message digest.
+	 */
+	bool verify_pkcs1_v1_5(const public_key& key, byte_string_view digest_info, byte_string_view signature);
+
+	/**
+	 * \brief RSASSA-PSS verification (RFC 8017, section 8.1.2) with MGF1 over `hash`.
+	 * \param salt_length Defaults to the digest length, as TLS 1.3 requires.
+	 */
+	bool verify_pss(const public_key& key, byte_string_view digest, const hash_function& hash,
+	                byte_string_view signature, std::optional<std::size_t> salt_length = std::nullopt);
+}
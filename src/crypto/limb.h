@@ -0,0 +1,133 @@
+#pragma once
+#include "byte_string.h"
+#include <cstdint>
+
+/// Multi-precision helpers over 64-bit limbs in little-endian limb order, shared by the RSA and P-256 code.
+namespace crypto::limb {
+
+	using limb_t = std::uint64_t;
+
+	/// Returns the low limb of `a * b + c + carry` and stores the high limb into `carry`.
+	inline limb_t mul_add(const limb_t a, const limb_t b, const limb_t c, limb_t& carry) {
+#ifdef __SIZEOF_INT128__
+		const auto __t = static_cast<unsigned __int128>(a) * b + c + carry;
+		carry = static_cast<limb_t>(__t >> 64);
+		return static_cast<limb_t>(__t);
+#else
+		const limb_t a_lo = a & 0xffffffff, a_hi = a >> 32, b_lo = b & 0xffffffff, b_hi = b >> 32;
+		const limb_t lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo, lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+		const limb_t cross = (lo_lo >> 32) + (hi_lo & 0xffffffff) + lo_hi;
+		limb_t lo = cross << 32 | lo_lo & 0xffffffff;
+		limb_t hi = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+		lo += c;
+		hi += lo < c;
+		lo += carry;
+		hi += lo < carry;
+		carry = hi;
+		return lo;
+#endif
+	}
+
+	inline limb_t add(limb_t* r, const limb_t* a, const limb_t* b, const std::size_t n) {
+		limb_t carry = 0;
+		for (std::size_t i = 0; i < n; ++i) {
+			const limb_t __s = a[i] + carry;
+			carry = __s < carry;
+			r[i] = __s + b[i];
+			carry += r[i] < __s;
+		}
+		return carry;
+	}
+
+	inline limb_t sub(limb_t* r, const limb_t* a, const limb_t* b, const std::size_t n) {
+		limb_t borrow = 0;
+		for (std::size_t i = 0; i < n; ++i) {
+			const limb_t __d = a[i] - b[i];
+			const limb_t __b = a[i] < b[i];
+			r[i] = __d - borrow;
+			borrow = __b | __d < borrow;
+		}
+		return borrow;
+	}
+
+	inline int compare(const limb_t* a, const limb_t* b, const std::size_t n) {
+		for (std::size_t i = n; i-- > 0; )
+			if (a[i] != b[i])
+				return a[i] < b[i] ? -1 : 1;
+		return 0;
+	}
+
+	inline bool is_zero(const limb_t* a, const std::size_t n) {
+		for (std::size_t i = 0; i < n; ++i)
+			if (a[i])
+				return false;
+		return true;
+	}
+
+	/// -m^-1 mod 2^64 for odd `m`, by Newton iteration.
+	inline limb_t negative_inverse(const limb_t m) {
+		limb_t __x = m;
+		for (int i = 0; i < 5; ++i)
+			__x *= 2 - m * __x;
+		return -__x;
+	}
+
+	/**
+	 * \brief Montgomery multiplication (CIOS): `r = a * b * 2^(-64n) mod m`, given `a, b < m`.
+	 * \param scratch At least `n + 2` limbs.
+	 */
+	inline void mont_mul(limb_t* r, const limb_t* a, const limb_t* b, const limb_t* m, const limb_t m_inv,
+	                     const std::size_t n, limb_t* scratch) {
+		std::fill_n(scratch, n + 2, 0);
+		for (std::size_t i = 0; i < n; ++i) {
+			limb_t carry = 0;
+			for (std::size_t j = 0; j < n; ++j)
+				scratch[j] = mul_add(a[j], b[i], scratch[j], carry);
+			scratch[n] += carry;
+			scratch[n + 1] = scratch[n] < carry;
+			const limb_t __q = scratch[0] * m_inv;
+			carry = 0;
+			mul_add(__q, m[0], scratch[0], carry);
+			for (std::size_t j = 1; j < n; ++j)
+				scratch[j - 1] = mul_add(__q, m[j], scratch[j], carry);
+			scratch[n - 1] = scratch[n] + carry;
+			scratch[n] = scratch[n + 1] + (scratch[n - 1] < carry);
+		}
+		if (scratch[n] || compare(scratch, m, n) >= 0)
+			sub(r, scratch, m, n);
+		else
+			std::copy_n(scratch, n, r);
+	}
+
+	/// `a = 2a mod m`, given `a < m`.
+	inline void double_mod(limb_t* a, const limb_t* m, const std::size_t n) {
+		const limb_t __top = a[n - 1] >> 63;
+		for (std::size_t i = n - 1; i > 0; --i)
+			a[i] = a[i] << 1 | a[i - 1] >> 63;
+		a[0] <<= 1;
+		if (__top || compare(a, m, n) >= 0)
+			sub(a, a, m, n);
+	}
+
+	/// Loads a big-endian string into `n` limbs; the value must fit.
+	inline void from_bytes(limb_t* r, const byte_string_view be, const std::size_t n) {
+		std::fill_n(r, n, 0);
+		for (std::size_t i = 0; i < be.size(); ++i) {
+			const auto __pos = be.size() - 1 - i;
+			if (i / 8 >= n) {
+				if (be[__pos])
+					throw std::runtime_error{"integer does not fit"};
+				continue;
+			}
+			r[i / 8] |= static_cast<limb_t>(be[__pos]) << i % 8 * 8;
+		}
+	}
+
+	/// Stores `n` limbs as a big-endian string of `size` octets, truncating high limbs.
+	inline byte_string to_bytes(const limb_t* a, const std::size_t n, const std::size_t size) {
+		byte_string __r(size, 0);
+		for (std::size_t i = 0; i < size && i / 8 < n; ++i)
+			__r[size - 1 - i] = static_cast<std::uint8_t>(a[i / 8] >> i % 8 * 8);
+		return __r;
+	}
+}
@@ -0,0 +1,265 @@
+#include "crypto/ecc.h"
+#include "limb.h"
+#include <array>
+
+using namespace crypto::limb;
+namespace limb = crypto::limb;
+
+namespace {
+
+	using element = std::array<limb_t, 4>;
+
+	/// Arithmetic modulo a 256-bit odd modulus, with operands in Montgomery form.
+	struct modulus {
+
+		element m;
+
+		limb_t m_inv;
+
+		/// R mod m and R^2 mod m, where R = 2^256.
+		element one, r2;
+
+		explicit modulus(const element& __m): m(__m), m_inv(negative_inverse(__m[0])), one{1}, r2{} {
+			for (int i = 0; i < 256; ++i)
+				double_mod(one.data(), m.data(), 4);
+			r2 = one;
+			for (int i = 0; i < 256; ++i)
+				double_mod(r2.data(), m.data(), 4);
+		}
+
+		[[nodiscard]] element mul(const element& a, const element& b) const {
+			element __r;
+			limb_t __scratch[6];
+			mont_mul(__r.data(), a.data(), b.data(), m.data(), m_inv, 4, __scratch);
+			return __r;
+		}
+
+		[[nodiscard]] element sqr(const element& a) const {
+			return mul(a, a);
+		}
+
+		[[nodiscard]] element add(const element& a, const element& b) const {
+			element __r;
+			if (limb::add(__r.data(), a.data(), b.data(), 4) || compare(__r.data(), m.data(), 4) >= 0)
+				limb::sub(__r.data(), __r.data(), m.data(), 4);
+			return __r;
+		}
+
+		[[nodiscard]] element sub(const element& a, const element& b) const {
+			element __r;
+			if (limb::sub(__r.data(), a.data(), b.data(), 4))
+				limb::add(__r.data(), __r.data(), m.data(), 4);
+			return __r;
+		}
+
+		[[nodiscard]] element to_montgomery(const element& a) const {
+			return mul(a, r2);
+		}
+
+		[[nodiscard]] element from_montgomery(const element& a) const {
+			return mul(a, {1});
+		}
+
+		/// a^(m - 2), the inverse of `a` for prime `m`.
+		[[nodiscard]] element inverse(const element& a) const {
+			element __e = m;
+			__e[0] -= 2;
+			element __r = one;
+			for (std::size_t i = 256; i-- > 0; ) {
+				__r = sqr(__r);
+				if (__e[i / 64] >> i % 64 & 1)
+					__r = mul(__r, a);
+			}
+			return __r;
+		}
+	};
+
+	const modulus& field() {
+		static const modulus __f{{0xffffffffffffffff, 0x00000000ffffffff, 0x0000000000000000, 0xffffffff00000001}};
+		return __f;
+	}
+
+	const modulus& order() {
+		static const modulus __n{{0xf3b9cac2fc632551, 0xbce6faada7179e84, 0xffffffffffffffff, 0xffffffff00000000}};
+		return __n;
+	}
+
+	/// Jacobian coordinates in Montgomery form; Z = 0 is the point at infinity.
+	struct point {
+
+		element x, y, z;
+
+		[[nodiscard]] bool infinity() const {
+			return is_zero(z.data(), 4);
+		}
+	};
+
+	/// dbl-2001-b, using a = -3.
+	point dbl(const point& p) {
+		if (p.infinity())
+			return p;
+		const auto& __f = field();
+		const auto __delta = __f.sqr(p.z), __gamma = __f.sqr(p.y), __beta = __f.mul(p.x, __gamma);
+		const auto __t = __f.mul(__f.sub(p.x, __delta), __f.add(p.x, __delta));
+		const auto __alpha = __f.add(__f.add(__t, __t), __t);
+		const auto __beta4 = __f.add(__f.add(__beta, __beta), __f.add(__beta, __beta));
+		point __r;
+		__r.x = __f.sub(__f.sqr(__alpha), __f.add(__beta4, __beta4));
+		__r.z = __f.sub(__f.sub(__f.sqr(__f.add(p.y, p.z)), __gamma), __delta);
+		auto __g2 = __f.sqr(__gamma);
+		__g2 = __f.add(__g2, __g2);
+		__g2 = __f.add(__g2, __g2);
+		__r.y = __f.sub(__f.mul(__alpha, __f.sub(__beta4, __r.x)), __f.add(__g2, __g2));
+		return __r;
+	}
+
+	/// add-2007-bl.
+	point add(const point& p, const point& q) {
+		if (p.infinity())
+			return q;
+		if (q.infinity())
+			return p;
+		const auto& __f = field();
+		const auto __z1z1 = __f.sqr(p.z), __z2z2 = __f.sqr(q.z);
+		const auto __u1 = __f.mul(p.x, __z2z2), __u2 = __f.mul(q.x, __z1z1);
+		const auto __s1 = __f.mul(__f.mul(p.y, q.z), __z2z2), __s2 = __f.mul(__f.mul(q.y, p.z), __z1z1);
+		const auto __h = __f.sub(__u2, __u1);
+		auto __r = __f.sub(__s2, __s1);
+		if (is_zero(__h.data(), 4))
+			return is_zero(__r.data(), 4) ? dbl(p) : point{};
+		__r = __f.add(__r, __r);
+		const auto __i = __f.sqr(__f.add(__h, __h)), __j = __f.mul(__h, __i), __v = __f.mul(__u1, __i);
+		point __o;
+		__o.x = __f.sub(__f.sub(__f.sqr(__r), __j), __f.add(__v, __v));
+		const auto __s1j = __f.mul(__s1, __j);
+		__o.y = __f.sub(__f.mul(__r, __f.sub(__v, __o.x)), __f.add(__s1j, __s1j));
+		__o.z = __f.mul(__f.sub(__f.sub(__f.sqr(__f.add(p.z, q.z)), __z1z1), __z2z2), __h);
+		return __o;
+	}
+
+	using window_table = std::array<point, 16>;
+
+	/// 0·P, 1·P, ..., 15·P for 4-bit windows.
+	window_table multiples(const point& p) {
+		window_table __t{};
+		__t[1] = p;
+		for (std::size_t i = 2; i < 16; ++i)
+			__t[i] = i % 2 ? add(__t[i - 1], p) : dbl(__t[i / 2]);
+		return __t;
+	}
+
+	/// Window table of the generator, normalized to Z = 1 once per process.
+	const window_table& generator_table() {
+		static const window_table __t = [] {
+			const auto& __f = field();
+			point __g;
+			from_bytes(__g.x.data(), byte_string{
+				0x6b, 0x17, 0xd1, 0xf2, 0xe1, 0x2c, 0x42, 0x47, 0xf8, 0xbc, 0xe6, 0xe5, 0x63, 0xa4, 0x40, 0xf2,
+				0x77, 0x03, 0x7d, 0x81, 0x2d, 0xeb, 0x33, 0xa0, 0xf4, 0xa1, 0x39, 0x45, 0xd8, 0x98, 0xc2, 0x96}, 4);
+			from_bytes(__g.y.data(), byte_string{
+				0x4f, 0xe3, 0x42, 0xe2, 0xfe, 0x1a, 0x7f, 0x9b, 0x8e, 0xe7, 0xeb, 0x4a, 0x7c, 0x0f, 0x9e, 0x16,
+				0x2b, 0xce, 0x33, 0x57, 0x6b, 0x31, 0x5e, 0xce, 0xcb, 0xb6, 0x40, 0x68, 0x37, 0xbf, 0x51, 0xf5}, 4);
+			__g.x = __f.to_montgomery(__g.x);
+			__g.y = __f.to_montgomery(__g.y);
+			__g.z = __f.one;
+			auto __t = multiples(__g);
+			for (std::size_t i = 1; i < 16; ++i) {
+				auto& __p = __t[i];
+				const auto __zi = __f.inverse(__p.z), __zi2 = __f.sqr(__zi);
+				__p = {__f.mul(__p.x, __zi2), __f.mul(__p.y, __f.mul(__zi2, __zi)), __f.one};
+			}
+			return __t;
+		}();
+		return __t;
+	}
+
+	const element& curve_b() {
+		static const element __b = [] {
+			element __v;
+			from_bytes(__v.data(), byte_string{
+				0x5a, 0xc6, 0x35, 0xd8, 0xaa, 0x3a, 0x93, 0xe7, 0xb3, 0xeb, 0xbd, 0x55, 0x76, 0x98, 0x86, 0xbc,
+				0x65, 0x1d, 0x06, 0xb0, 0xcc, 0x53, 0xb0, 0xf6, 0x3b, 0xce, 0x3c, 0x3e, 0x27, 0xd2, 0x60, 0x4b}, 4);
+			return field().to_montgomery(__v);
+		}();
+		return __b;
+	}
+
+	unsigned nibble(const element& k, const std::size_t i) {
+		return k[i / 16] >> i % 16 * 4 & 0xf;
+	}
+
+	/// Straus-Shamir joint multiplication u1·G + u2·Q sharing one chain of doublings.
+	point joint_multiply(const element& u1, const element& u2, const point& q) {
+		const auto& __g = generator_table();
+		const auto __q = multiples(q);
+		point __r{};
+		for (std::size_t i = 64; i-- > 0; ) {
+			for (int j = 0; j < 4 && !__r.infinity(); ++j)
+				__r = dbl(__r);
+			if (const auto __d = nibble(u1, i))
+				__r = add(__r, __g[__d]);
+			if (const auto __d = nibble(u2, i))
+				__r = add(__r, __q[__d]);
+		}
+		return __r;
+	}
+}
+
+namespace crypto::ecc {
+
+	bool p256_verify(const byte_string_view public_key, const byte_string_view digest, const byte_string_view r,
+	                 const byte_string_view s) {
+		const auto& __f = field();
+		const auto& __n = order();
+		if (public_key.size() != 65 || public_key[0] != 0x04)
+			return false;
+
+		point __q;
+		try {
+			from_bytes(__q.x.data(), public_key.substr(1, 32), 4);
+			from_bytes(__q.y.data(), public_key.substr(33, 32), 4);
+		} catch (const std::runtime_error&) {
+			return false;
+		}
+		if (compare(__q.x.data(), __f.m.data(), 4) >= 0 || compare(__q.y.data(), __f.m.data(), 4) >= 0)
+			return false;
+		__q.x = __f.to_montgomery(__q.x);
+		__q.y = __f.to_montgomery(__q.y);
+		__q.z = __f.one;
+		// y^2 = x^3 - 3x + b
+		const auto __x3 = __f.mul(__f.sqr(__q.x), __q.x);
+		const auto __3x = __f.add(__f.add(__q.x, __q.x), __q.x);
+		if (__f.sqr(__q.y) != __f.add(__f.sub(__x3, __3x), curve_b()))
+			return false;
+
+		element __r, __s;
+		try {
+			from_bytes(__r.data(), r, 4);
+			from_bytes(__s.data(), s, 4);
+		} catch (const std::runtime_error&) {
+			return false;
+		}
+		if (is_zero(__r.data(), 4) || is_zero(__s.data(), 4)
+				|| compare(__r.data(), __n.m.data(), 4) >= 0 || compare(__s.data(), __n.m.data(), 4) >= 0)
+			return false;
+
+		// leftmost 256 bits of the digest, reduced mod n
+		element __e;
+		from_bytes(__e.data(), digest.substr(0, 32), 4);
+		if (compare(__e.data(), __n.m.data(), 4) >= 0)
+			limb::sub(__e.data(), __e.data(), __n.m.data(), 4);
+
+		// Montgomery products of a plain and a Montgomery-form operand come out plain
+		const auto __w = __n.inverse(__n.to_montgomery(__s));
+		const auto __u1 = __n.mul(__e, __w), __u2 = __n.mul(__r, __w);
+		const auto __p = joint_multiply(__u1, __u2, __q);
+		if (__p.infinity())
+			return false;
+
+		const auto __zi = __f.inverse(__p.z);
+		auto __x = __f.from_montgomery(__f.mul(__p.x, __f.sqr(__zi)));
+		if (compare(__x.data(), __n.m.data(), 4) >= 0)
+			limb::sub(__x.data(), __x.data(), __n.m.data(), 4);
+		return __x == __r;
+	}
+}
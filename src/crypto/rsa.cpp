@@ -0,0 +1,122 @@
+#include "crypto/rsa.h"
+#include "limb.h"
+#include <algorithm>
+#include <vector>
+
+using crypto::limb::limb_t;
+
+namespace {
+
+	byte_string mgf1(const crypto::rsa::hash_function& hash, const byte_string_view seed, const std::size_t length) {
+		byte_string __mask, __input{seed};
+		__input.append(4, 0);
+		for (std::uint32_t __counter = 0; __mask.size() < length; ++__counter) {
+			for (std::size_t i = 0; i < 4; ++i)
+				__input[seed.size() + i] = static_cast<std::uint8_t>(__counter >> (24 - 8 * i));
+			__mask += hash(__input);
+		}
+		__mask.resize(length);
+		return __mask;
+	}
+}
+
+namespace crypto::rsa {
+
+	std::size_t public_key::size() const {
+		return (modulus.bit_used() + 7) / 8;
+	}
+
+	byte_string verify_primitive(const public_key& key, const byte_string_view signature) {
+		const auto __k = key.size();
+		if (signature.size() != __k)
+			throw std::runtime_error{"signature length does not match modulus"};
+		const auto __n = (__k + 7) / 8;
+		// modulus, base, accumulator, product and scratch space in one allocation
+		std::vector<limb_t> __buf(6 * __n + 2);
+		const auto __m = __buf.data(), __s = __m + __n, __acc = __s + __n, __t = __acc + __n, __one = __t + __n,
+			__scratch = __one + __n;
+		limb::from_bytes(__m, key.modulus.to_bytestring(std::endian::big), __n);
+		if (!(__m[0] & 1))
+			throw std::runtime_error{"modulus must be odd"};
+		limb::from_bytes(__s, signature, __n);
+		if (limb::compare(__s, __m, __n) >= 0)
+			throw std::runtime_error{"signature representative out of range"};
+		const auto __m_inv = limb::negative_inverse(__m[0]);
+
+		// s * R mod m by doubling; cheaper than computing R^2 mod m for a single exponentiation
+		for (std::size_t i = 0; i < 64 * __n; ++i)
+			limb::double_mod(__s, __m, __n);
+
+		// left-to-right square-and-multiply; a small public exponent such as 65537 needs only 17 products
+		const auto __e = key.exponent.to_bytestring(std::endian::big);
+		bool __started = false;
+		for (const auto __octet: __e)
+			for (int __bit = 7; __bit >= 0; --__bit) {
+				if (__started) {
+					limb::mont_mul(__t, __acc, __acc, __m, __m_inv, __n, __scratch);
+					std::copy_n(__t, __n, __acc);
+				}
+				if (__octet >> __bit & 1) {
+					if (__started) {
+						limb::mont_mul(__t, __acc, __s, __m, __m_inv, __n, __scratch);
+						std::copy_n(__t, __n, __acc);
+					} else
+						std::copy_n(__s, __n, __acc);
+					__started = true;
+				}
+			}
+		if (!__started)
+			throw std::runtime_error{"public exponent must not be zero"};
+
+		__one[0] = 1;
+		limb::mont_mul(__t, __acc, __one, __m, __m_inv, __n, __scratch);
+		return limb::to_bytes(__t, __n, __k);
+	}
+
+	bool verify_pkcs1_v1_5(const public_key& key, const byte_string_view digest_info, const byte_string_view signature) {
+		const auto __k = key.size();
+		if (signature.size() != __k || __k < digest_info.size() + 11)
+			return false;
+		const auto __em = verify_primitive(key, signature);
+		byte_string __expected{0, 1};
+		__expected.append(__k - digest_info.size() - 3, 0xff);
+		__expected.push_back(0);
+		__expected.append(digest_info);
+		return __em == __expected;
+	}
+
+	bool verify_pss(const public_key& key, const byte_string_view digest, const hash_function& hash,
+	                const byte_string_view signature, const std::optional<std::size_t> salt_length) {
+		const auto __k = key.size();
+		if (signature.size() != __k)
+			return false;
+		const auto __em_bits = key.modulus.bit_used() - 1;
+		const auto __em_len = (__em_bits + 7) / 8;
+		const auto __h_len = digest.size(), __s_len = salt_length.value_or(__h_len);
+		auto __em = verify_primitive(key, signature);
+		if (__em_len < __k) {
+			if (__em.front())
+				return false;
+			__em.erase(0, 1);
+		}
+		if (__em_len < __h_len + __s_len + 2 || __em.back() != 0xbc)
+			return false;
+		const auto __db_len = __em_len - __h_len - 1;
+		const byte_string_view __h{__em.data() + __db_len, __h_len};
+		const std::uint8_t __top_mask = 0xff >> (8 * __em_len - __em_bits);
+		if (__em[0] & ~__top_mask)
+			return false;
+		auto __db = mgf1(hash, __h, __db_len);
+		for (std::size_t i = 0; i < __db_len; ++i)
+			__db[i] ^= __em[i];
+		__db[0] &= __top_mask;
+		const auto __ps_len = __db_len - __s_len - 1;
+		if (std::ranges::any_of(__db.begin(), __db.begin() + __ps_len, [](const auto __c) { return __c != 0; })
+				|| __db[__ps_len] != 0x01)
+			return false;
+		byte_string __m(8, 0);
+		__m += digest;
+		__m.append(__db, __db_len - __s_len);
+		return hash(__m) == __h;
+	}
+}
@@ -1,6 +1,8 @@
 #include "http/message.h"
 #include "internal/utils.h"
 #include "custom_std/hash.h"
+#include <algorithm>
+#include <cctype>
 #include <format>
 
 using namespace internal;
@@ -9,29 +11,38 @@ constexpr std::string_view WS{" \t"};
 
 namespace network::http {
 
-	std::string& fields::append(const std::string_view name, const std::string_view value, const std::string_view sep) {
-		auto lower_name = to_lower(name);
-		if (!contains(lower_name))
-			return set(name, value);
-		auto& field = at(lower_name);
+	std::pmr::string& fields::append(const std::string_view name, const std::string_view value, const std::string_view sep) {
+		auto __key = lower_key_(name);
+		const auto it = find(__key);
+		if (it == end())
+			return emplace(std::move(__key), value).first->second;
+		auto& field = it->second;
 		field += sep;
 		return field += value;
 	}
 
-	std::string& fields::set(const std::string_view name, const std::string_view value) {
-		return operator[](to_lower(name)) = value;
+	std::pmr::string& fields::set(const std::string_view name, const std::string_view value) {
+		return insert_or_assign(lower_key_(name), value).first->second;
+	}
+
+	std::pmr::string fields::lower_key_(const std::string_view name) const {
+		// built with the map's allocator rather than through to_lower(), so a whole parsed head lives in its resource
+		std::pmr::string __key{name, get_allocator()};
+		std::ranges::transform(__key, __key.begin(), [](const unsigned char c) { return std::tolower(c); });
+		return __key;
 	}
 
 	fields::operator std::string() const {
 		std::string str;
-		for (auto& [field, value]: *this)
-			str += std::format("{}: {}\r\n", field, value);
+		format_to(std::back_inserter(str));
 		return str;
 	}
 
-	bool internal::field_name_less::operator()(const std::string& lhs, const std::string& rhs) const {
-		const auto result = lhs <=> rhs;
-		return std::is_gt(result) && lhs == "host" || std::is_lt(result);
+	bool internal::field_name_less::operator()(const std::string_view lhs, const std::string_view rhs) const {
+		// host goes first; a strict weak order, or lookups miss fields ordered before it
+		if (lhs == "host" || rhs == "host")
+			return lhs == "host" && rhs != "host";
+		return lhs < rhs;
 	}
 
 	std::expected<fields, field_parse_error> fields::from_http_headers(istream& __s) {
@@ -55,6 +66,30 @@ namespace network::http {
 		return fields;
 	}
 
+	std::expected<fields, field_parse_error> fields::from_http_headers(buffered_stream& __s, std::pmr::memory_resource* __m) {
+		fields fields(__m);
+		for (;;) {
+			const auto __line = __s.read_until('\n');
+			if (!__line)
+				return std::unexpected{field_parse_error::invalid_line_folding};
+			const std::string_view __fl{reinterpret_cast<const char*>(__line->data()), __line->size() - 1};
+			if (!__fl.ends_with('\r') || __fl.find('\r') != __fl.size() - 1)
+				return std::unexpected{field_parse_error::invalid_line_folding};
+			if (__fl.length() == 1)
+				// only contains CR; end of fields
+				break;
+			if (WS.contains(__fl.front()))
+				return std::unexpected{field_parse_error::obsolete_line_folding};
+			const auto __c = __fl.find(':');
+			if (__c == std::string_view::npos)
+				return std::unexpected{field_parse_error::missing_colon};
+			if (__c == 0 || WS.contains(__fl[__c - 1]))
+				return std::unexpected{field_parse_error::invalid_whitespace_after_name};
+			fields.append(__fl.substr(0, __c), trim(__fl.substr(__c + 1, __fl.size() - __c - 2)));
+		}
+		return fields;
+	}
+
 	fields fields::from_event_stream(istream& __s) {
 		fields fields;
 		bool __end_cr = false;
@@ -1,5 +1,8 @@
 #include "http1_1/client.h"
 #include "http1_1/common.h"
+#include "http1_1/parser.h"
+#include <array>
+#include <algorithm>
 #include <ranges>
 #include <iostream>
 
@@ -9,9 +12,16 @@ namespace network::http {
 	constexpr auto literal_location = "location";
 
 	void client::connect_(const std::string_view host, const tcp_port_t port) {
-		if (base_.connected() && connected_host_ == host && connected_port_ == port)
+		if (base_.connected() && connected_host_ == host && connected_port_ == port && body_finished_)
 			return;
-		base_.close();
+		if (!body_finished_) {
+			// the rest of an abandoned body would be taken for the next response; nor may a pool reuse the connection
+			base_.close();
+			body_finished_ = true;
+		}
+		// connect() closes the previous connection itself; a pooled one is handed back instead
+		reader_.clear();
+		head_length_ = 0;
 		base_.connect(host, port);
 		connected_host_ = host;
 		connected_port_ = port;
@@ -19,45 +29,8 @@ namespace network::http {
 
 	response client::fetch(request _req) try {
 		for (std::size_t redirection_count = 0; redirection_count < 7; ++redirection_count) {
-			const auto __p = [&] -> tcp_port_t {
-				if (_req.target.port)
-					return _req.target.port;
-				if (_req.target.scheme == "http")
-					return 80;
-				if (_req.target.scheme == "https")
-					return 443;
-				throw std::invalid_argument("unknown scheme or set port explicitly");
-			}();
-			connect_(_req.target.host, __p);
-			auto copy = _req.headers;
-			copy.set("host", _req.target.host);
-			if (!_req.content.empty())
-				copy.set("content-length", std::to_string(_req.content.length()));
-			const auto req_str
-					= std::format("{} {} HTTP/1.1\r\n{}\r\n{}", _req.method, _req.target.origin_form(),
-								static_cast<std::string>(copy), _req.content);
-			base_.write(reinterpret_cast<const byte_string&>(req_str));
-			const auto stat_l = base_.read_line();
-			if (!stat_l.ends_with('\r') || base_.read() != '\n')
-				throw client_error("fetch(request): status-line: invalid line folding");
-			if (!stat_l.starts_with("HTTP/"))
-				throw client_error("fetch(request): invalid HTTP response");
-			const auto ws1 = stat_l.find(' ', 5);
-			if (ws1 == std::string::npos)
-				throw client_error("fetch(request): invalid HTTP response");
-			const auto ws2 = stat_l.find(' ', ws1 + 1);
-			if (ws2 == std::string::npos)
-				throw client_error("fetch(request): invalid HTTP response");
-			response res;
-			const auto stat_code = stat_l.substr(ws1 + 1, ws2 - ws1 - 1);
-			const auto begin = stat_code.data(), end = begin + stat_code.size();
-			if (std::from_chars(begin, end, reinterpret_cast<std::uint16_t&>(res.code)).ec != std::errc{})
-				throw client_error("fetch(request): ill-formed status code");
-			res.headers = fields::from_http_headers(base_).value();
-			if (informational(res.code) || res.code == status::no_content || res.code == status::not_modified)
-				// no response body for 1XX, 204, 304
-				return res;
-			res.content = read_message_content(base_, res.headers, message_type::response).value();
+			auto res = fetch_head(_req);
+			read_content_(res, _req.method);
 			if (!redirection(res.code) || !res.headers.contains(literal_location))
 				return res;
 			_req.target = _req.target.from_relative(res.headers.at(literal_location));
@@ -65,6 +38,193 @@ namespace network::http {
 		return {};
 	} catch (const std::exception& e) {
 		std::cerr << std::format("exception thrown while fetching: {}\n", e.what());
+		// whatever is left of the response is not the start of the next one
+		base_.close();
 		return {};
 	}
+
+	std::future<response> client::pipeline(request req) {
+		if (std::ranges::find(safe_methods, req.method) == std::end(safe_methods)
+				&& std::ranges::find(idempotent_methods, req.method) == std::end(idempotent_methods))
+			throw std::invalid_argument(std::format("pipeline: {} is not idempotent", req.method));
+		port_(req.target);
+		auto& __p = pipeline_.emplace_back(std::move(req));
+		return __p.promise.get_future();
+	}
+
+	void client::flush() {
+		while (!pipeline_.empty()) {
+			// the longest run of queued requests to one origin goes out in a single write
+			const auto& __target = pipeline_.front().req.target;
+			const auto __port = port_(__target);
+			std::size_t __batch = 0;
+			while (__batch < pipeline_.size() && pipeline_[__batch].req.target.host == __target.host
+					&& port_(pipeline_[__batch].req.target) == __port)
+				++__batch;
+			bool __broken = false;
+			try {
+				connect_(__target.host, __port);
+				std::pmr::vector<std::pmr::string> __heads{resource};
+				std::vector<byte_string_view> __buffers;
+				__heads.reserve(__batch);
+				__buffers.reserve(2 * __batch);
+				for (std::size_t i = 0; i < __batch; ++i) {
+					const auto& __r = pipeline_[i].req;
+					format_head_(__r, __heads.emplace_back());
+					__buffers.emplace_back(reinterpret_cast<const std::uint8_t*>(__heads.back().data()), __heads.back().size());
+					__buffers.push_back(reinterpret_cast<const byte_string&>(__r.content));
+				}
+				base_.write(__buffers);
+				while (__batch) {
+					auto __r = read_response_(pipeline_.front().req);
+					while (informational(__r.code))
+						__r = read_response_(pipeline_.front().req);
+					const auto __c = __r.headers.find("connection");
+					const bool __close = __c != __r.headers.end() && __c->second.contains("close");
+					pipeline_.front().promise.set_value(std::move(__r));
+					pipeline_.pop_front();
+					--__batch;
+					if (__close) {
+						// the server answers no more on this connection; the rest is sent again on a new one
+						base_.close();
+						break;
+					}
+				}
+			} catch (const std::exception&) {
+				// responses were lost with the connection; idempotent requests are safe to send once more
+				base_.close();
+				__broken = true;
+			}
+			if (!__broken)
+				continue;
+			for (std::size_t i = 0; i < __batch; ) {
+				if (auto& __p = pipeline_[i]; __p.retried) {
+					__p.promise.set_exception(std::make_exception_ptr(
+						client_error("pipeline: connection closed before the response")));
+					pipeline_.erase(pipeline_.begin() + i);
+					--__batch;
+				} else {
+					__p.retried = true;
+					++i;
+				}
+			}
+		}
+	}
+
+	tcp_port_t client::port_(const uri& target) {
+		if (target.port)
+			return target.port;
+		if (target.scheme == "http")
+			return 80;
+		if (target.scheme == "https")
+			return 443;
+		throw std::invalid_argument("unknown scheme or set port explicitly");
+	}
+
+	void client::format_head_(const request& req, std::pmr::string& out) const {
+		fields copy(req.headers, resource);
+		copy.set("host", req.target.host);
+		if (!req.content.empty())
+			copy.set("content-length", std::to_string(req.content.length()));
+		std::format_to(std::back_inserter(out), "{} {} HTTP/1.1\r\n", req.method, req.target.origin_form());
+		copy.format_to(std::back_inserter(out));
+		out += "\r\n";
+	}
+
+	response client::fetch_head(const request& req) {
+		const auto& __head = send_and_read_head_(req);
+		response __res{{__head.to_fields(resource)}, __head.code, {}};
+		reader_.consume(std::exchange(head_length_, 0));
+		return __res;
+	}
+
+	body_reader client::body(const response& head) {
+		return body_(head, head_method_);
+	}
+
+	const response_head_view& client::fetch_head_view(const request& req) {
+		return send_and_read_head_(req);
+	}
+
+	body_reader client::body(const response_head_view& head) {
+		auto __b = body_(head, head_method_);
+		reader_.consume(std::exchange(head_length_, 0));
+		return __b;
+	}
+
+	const response_head_view& client::send_and_read_head_(const request& req) {
+		connect_(req.target.host, port_(req.target));
+		std::pmr::string req_head{resource};
+		format_head_(req, req_head);
+		const std::array<byte_string_view, 2> req_buffers{
+			byte_string_view{reinterpret_cast<const std::uint8_t*>(req_head.data()), req_head.size()},
+			reinterpret_cast<const byte_string&>(req.content)};
+		base_.write(req_buffers);
+		head_method_ = req.method;
+		const auto& __head = read_head_view_();
+		// the connection is reusable once the content is read through body()
+		body_finished_ = body_(__head, req.method).remaining() == 0;
+		return __head;
+	}
+
+	const response_head_view& client::read_head_view_() {
+		reader_.consume(std::exchange(head_length_, 0));
+		auto& __head = head_.emplace(resource);
+		const auto __length = read_head(reader_, __head, max_head_size);
+		if (!__length && __length.error() == head_parse_error::incomplete)
+			throw client_error(reader_.buffered()
+				? "fetch(request): connection closed within response head"
+				: "fetch(request): connection closed before status-line");
+		if (!__length)
+			throw client_error(__length.error() == head_parse_error::invalid_status_code
+				? "fetch(request): ill-formed status code"
+				: __length.error() == head_parse_error::head_too_large
+				? "fetch(request): response head too large"
+				: "fetch(request): invalid HTTP response");
+		head_length_ = __length.value();
+		return __head;
+	}
+
+	response client::read_head_() {
+		const auto& __head = read_head_view_();
+		response res{{__head.to_fields(resource)}, __head.code, {}};
+		reader_.consume(std::exchange(head_length_, 0));
+		return res;
+	}
+
+	response client::read_response_(const request& req) {
+		auto res = read_head_();
+		if (!read_content_(res, req.method))
+			throw client_error("fetch(request): connection closed within response content");
+		return res;
+	}
+
+	bool client::read_content_(response& res, const std::string_view method) {
+		auto __body = body_(res, method);
+		const auto __done = __body.read_all([&](const byte_string_view v) {
+			res.content.append(reinterpret_cast<const char*>(v.data()), v.size());
+			return true;
+		});
+		// a body cut short by the end of the stream is kept as far as it arrived
+		if (!__done && __done.error() != message_body_parse_error::content_truncated)
+			throw client_error("fetch(request): invalid response content");
+		return __done.has_value();
+	}
+
+	body_reader client::body_(const response& res, const std::string_view method) {
+		if (without_content_(res.code, method))
+			return body_reader{reader_, &body_finished_};
+		return {reader_, res.headers, message_type::response, &body_finished_};
+	}
+
+	body_reader client::body_(const response_head_view& head, const std::string_view method) {
+		if (without_content_(head.code, method))
+			return body_reader{reader_, &body_finished_};
+		return {reader_, head, message_type::response, &body_finished_};
+	}
+
+	bool client::without_content_(const status code, const std::string_view method) {
+		// no response body for 1XX, 204, 304, or a HEAD request
+		return informational(code) || code == status::no_content || code == status::not_modified || method == "HEAD";
+	}
 }
@@ -1,61 +1,193 @@
 #include "http1_1/common.h"
+#include <charconv>
 
 constexpr auto
 	literal_transfer_encoding = "transfer-encoding",
 	literal_content_length = "content-length",
 	literal_chunked = "chunked";
 
+/// Longest chunk-size or trailer line accepted, so a peer cannot make the reader buffer without bound.
+constexpr std::size_t max_chunk_line = 4096;
+
 namespace network::http {
 
-	std::expected<std::string, message_body_parse_error>
-	read_message_content(stream_endpoint& __s, const fields& __f, const message_type __t) {
-		if (__f.contains(literal_transfer_encoding)) {
-			if (__f.at(literal_transfer_encoding).contains(literal_chunked)) {
-				std::string __r;
-				while (true) {
-					const auto chunk_head = __s.read_line();
-					if (!chunk_head.ends_with('\r') || __s.read() != '\n')
-						return std::unexpected{message_body_parse_error::invalid_chunk_line_folding};
-					const auto __c = std::find(chunk_head.begin(), chunk_head.end() - 1, ';').base();
-					std::size_t chunk_len;
-					if (std::from_chars(chunk_head.data(), __c, chunk_len, 16).ptr != __c)
-						return std::unexpected{message_body_parse_error::invalid_chunk_size};
-					if (chunk_len > 0) {
-						const auto chunk_data = __s.read(chunk_len);
-						__r.append(reinterpret_cast<const std::string&>(chunk_data));
+	namespace {
+		/// Parses the whole of `s` as a number; an empty or overflowing one is an error, not a shorter length.
+		bool parse_size(const std::string_view s, std::size_t& value, const int base = 10) {
+			const auto __e = s.data() + s.size();
+			const auto [__p, __ec] = std::from_chars(s.data(), __e, value, base);
+			return __ec == std::errc{} && __p == __e;
+		}
+
+		/// Reads a line of chunked framing, returning it without the CRLF.
+		std::expected<std::string_view, message_body_parse_error> read_chunk_line(buffered_stream& source) {
+			const auto __line = source.read_until('\n', max_chunk_line);
+			if (!__line)
+				return std::unexpected{source.buffered() >= max_chunk_line
+					? message_body_parse_error::invalid_chunk_line_folding
+					: message_body_parse_error::content_truncated};
+			if (__line->size() < 2 || (*__line)[__line->size() - 2] != '\r')
+				return std::unexpected{message_body_parse_error::invalid_chunk_line_folding};
+			return std::string_view{reinterpret_cast<const char*>(__line->data()), __line->size() - 2};
+		}
+	}
+
+	body_reader::body_reader(buffered_stream& source, const fields& __f, const message_type __t, bool* const finished)
+		: source_(&source), finished_(finished) {
+		const auto __value = [&](const std::string_view name) -> std::optional<std::string_view> {
+			if (const auto __it = __f.find(name); __it != __f.end())
+				return __it->second;
+			return std::nullopt;
+		};
+		frame_(__value(literal_transfer_encoding), __value(literal_content_length), __t);
+	}
+
+	void body_reader::frame_(const head_view& __h, const message_type __t) {
+		std::optional<std::string_view> __transfer_encoding, __content_length;
+		bool __chunked = false;
+		for (const auto& [__name, __v]: __h.fields())
+			if (internal::iequals(__name, literal_transfer_encoding)) {
+				__transfer_encoding = __v;
+				__chunked |= __v.contains(literal_chunked);
+			} else if (internal::iequals(__name, literal_content_length))
+				// as in `fields`, repeated values combine into a list, which is no valid length
+				__content_length = __content_length ? std::string_view{} : __v;
+		frame_(__chunked ? std::optional<std::string_view>{literal_chunked} : __transfer_encoding, __content_length, __t);
+	}
+
+	void body_reader::frame_(const std::optional<std::string_view> transfer_encoding,
+		const std::optional<std::string_view> content_length, const message_type __t) {
+		if (transfer_encoding) {
+			if (transfer_encoding->contains(literal_chunked))
+				state_ = state::chunk_size;
+			else if (__t == message_type::request)
+				// other transfer encodings are not implemented
+				error_ = message_body_parse_error::cannot_determine_length;
+			else
+				state_ = state::until_close;
+		} else if (content_length) {
+			if (!parse_size(content_length.value(), remaining_))
+				error_ = message_body_parse_error::invalid_content_length;
+			else
+				state_ = state::length;
+		} else if (__t == message_type::response)
+			// delimited by closing the connection
+			state_ = state::until_close;
+	}
+
+	std::expected<byte_string_view, message_body_parse_error> body_reader::next(const std::size_t max) {
+		source_->consume(std::exchange(pending_, 0));
+		if (error_)
+			return std::unexpected{error_.value()};
+		while (true)
+			switch (state_) {
+				case state::done:
+					if (finished_)
+						*finished_ = true;
+					return byte_string_view{};
+				case state::length:
+					if (!remaining_) {
+						state_ = state::done;
+						continue;
+					}
+					if (!source_->buffered() && !source_->fill())
+						return fail_(message_body_parse_error::content_truncated);
+					return take_(std::min(remaining_, max));
+				case state::until_close:
+					if (!source_->buffered() && !source_->fill()) {
+						state_ = state::done;
+						continue;
 					}
-					if (__s.read(2) != reinterpret_cast<const std::uint8_t*>("\r\n"))
-						return std::unexpected{message_body_parse_error::invalid_chunk_line_folding};
-					if (chunk_len == 0)
-						break;
+					return take_(max);
+				case state::chunk_size: {
+					const auto __line = read_chunk_line(*source_);
+					if (!__line)
+						return fail_(__line.error());
+					// chunk extensions are ignored
+					if (!parse_size(__line->substr(0, __line->find(';')), remaining_, 16))
+						return fail_(message_body_parse_error::invalid_chunk_size);
+					state_ = remaining_ ? state::chunk_data : state::trailers;
+					continue;
 				}
-				return __r;
-			}
-			// other transfer encodings are not implemented
-			if (__t == message_type::request)
-				return std::unexpected{message_body_parse_error::cannot_determine_length};
-		} else if (__f.contains(literal_content_length)) {
-			auto& len = __f.at(literal_content_length);
-			const auto __b = len.data(), __e = __b + len.size();
-			std::size_t content_length;
-			if (std::from_chars(__b, __e, content_length).ptr != __e)
-				return std::unexpected{message_body_parse_error::invalid_content_length};
-			const auto content = __s.read(content_length);
-			return reinterpret_cast<const std::string&>(content);
-		}
-		switch (__t) {
-			case message_type::request:
-				return {};
-			case message_type::response: {
-				std::string __r;
-				while (__s.connected()) {
-					const auto b_str = __s.read(1024);
-					__r.append(b_str.begin(), b_str.end());
+				case state::chunk_data:
+					if (!remaining_) {
+						if (source_->peek(2).size() < 2)
+							return fail_(message_body_parse_error::content_truncated);
+						if (source_->peek(2) != reinterpret_cast<const std::uint8_t*>("\r\n"))
+							return fail_(message_body_parse_error::invalid_chunk_line_folding);
+						source_->consume(2);
+						state_ = state::chunk_size;
+						continue;
+					}
+					if (!source_->buffered() && !source_->fill())
+						return fail_(message_body_parse_error::content_truncated);
+					return take_(std::min(remaining_, max));
+				case state::trailers: {
+					// trailer fields are skipped up to the empty line ending the body
+					const auto __line = read_chunk_line(*source_);
+					if (!__line)
+						return fail_(__line.error());
+					if (__line->empty())
+						state_ = state::done;
+					continue;
 				}
-				return __r;
 			}
-			default:
-				throw std::runtime_error("unexpected message_type");
+	}
+
+	std::expected<std::size_t, message_body_parse_error> body_reader::read_some(const std::span<std::uint8_t> buffer) {
+		const auto __v = next(buffer.size());
+		if (!__v)
+			return std::unexpected{__v.error()};
+		std::ranges::copy(__v.value(), buffer.begin());
+		return __v->size();
+	}
+
+	std::expected<bool, message_body_parse_error>
+	body_reader::read_all(const std::function<bool(byte_string_view)>& on_data) {
+		while (true) {
+			const auto __v = next();
+			if (!__v)
+				return std::unexpected{__v.error()};
+			if (__v->empty())
+				return true;
+			if (!on_data(__v.value()))
+				return false;
 		}
 	}
+
+	std::expected<void, message_body_parse_error> body_reader::discard() {
+		const auto __r = read_all([](byte_string_view) { return true; });
+		if (!__r)
+			return std::unexpected{__r.error()};
+		return {};
+	}
+
+	byte_string_view body_reader::take_(const std::size_t max) {
+		pending_ = std::min(max, source_->buffered());
+		if (state_ != state::until_close)
+			remaining_ -= pending_;
+		return source_->peek(pending_);
+	}
+
+	std::unexpected<message_body_parse_error> body_reader::fail_(const message_body_parse_error e) {
+		error_ = e;
+		return std::unexpected{e};
+	}
+
+	std::expected<std::string, message_body_parse_error>
+	read_message_content(buffered_stream& __s, const fields& __f, const message_type __t) {
+		body_reader __b{__s, __f, __t};
+		std::string __r;
+		if (const auto __n = __b.remaining())
+			// bounded, as the length comes from the peer
+			__r.reserve(std::min<std::size_t>(__n.value(), 1 << 20));
+		const auto __done = __b.read_all([&](const byte_string_view v) {
+			__r.append(reinterpret_cast<const char*>(v.data()), v.size());
+			return true;
+		});
+		// a response cut short may still be of use; a request cut short is not acted on
+		if (!__done && (__t == message_type::request || __done.error() != message_body_parse_error::content_truncated))
+			return std::unexpected{__done.error()};
+		return __r;
+	}
 }
@@ -0,0 +1,159 @@
+#include "http1_1/runtime.h"
+#include <algorithm>
+#include <cctype>
+
+namespace network::http {
+
+	struct server_runtime::connection_ {
+
+		std::unique_ptr<serverside_endpoint> endpoint;
+
+		/// Socket under the endpoint, for waiting on the reactor and shutting down; `invalid_socket` for other transports.
+		socket_t socket = invalid_socket;
+
+		/// Set while the task blocks for the next request, on a transport that can not be shut down for reading.
+		std::atomic<bool> idle = false;
+	};
+
+	namespace {
+
+		bool wants_close(const fields& headers) {
+			const auto __it = headers.find("connection");
+			if (__it == headers.end())
+				return false;
+			std::string __v{__it->second};
+			std::ranges::transform(__v, __v.begin(), [](const unsigned char c) { return std::tolower(c); });
+			return __v.contains("close");
+		}
+	}
+
+	server_runtime::server_runtime(server& s, handler h, const std::size_t workers)
+		: server_(s), handler_(std::move(h)), pool_(workers) {
+#ifdef PLATFORM_Linux
+		poller_ = std::thread{[this] {
+			loop_.run();
+		}};
+#endif
+	}
+
+	server_runtime::~server_runtime() {
+		stop();
+	}
+
+	void server_runtime::run() {
+		while (!stopping_) {
+			std::unique_ptr<serverside_endpoint> __e;
+			try {
+				__e = server_.accept();
+			} catch (const std::exception&) {
+				// the listener was closed by stop(), or the connection failed before it was accepted
+				if (stopping_)
+					break;
+				continue;
+			}
+			auto __c = std::make_shared<connection_>();
+			if (const auto __t = dynamic_cast<const tcp::endpoint*>(&__e->base()))
+				__c->socket = __t->native_handle();
+			__c->endpoint = std::move(__e);
+			{
+				std::lock_guard __l{mutex_};
+				open_.insert(__c);
+			}
+			pool_.submit([this, __c] {
+				serve_(__c);
+			});
+		}
+	}
+
+	void server_runtime::stop(const std::chrono::milliseconds grace) {
+		if (stopping_.exchange(true))
+			return;
+		server_.close();
+		std::unique_lock __l{mutex_};
+		for (const auto& __c: open_)
+			if (__c->socket != invalid_socket)
+				::shutdown(__c->socket, SHUT_RD);
+			else if (__c->idle)
+				try {
+					__c->endpoint->finish();
+				} catch (const std::exception&) {
+					// already closed by the peer
+				}
+		if (!ended_.wait_for(__l, grace, [this] { return open_.empty(); }))
+			for (const auto& __c: open_)
+				if (__c->socket != invalid_socket)
+					::shutdown(__c->socket, SHUT_RDWR);
+		ended_.wait(__l, [this] { return open_.empty(); });
+		__l.unlock();
+#ifdef PLATFORM_Linux
+		loop_.stop();
+		poller_.join();
+#endif
+	}
+
+	std::size_t server_runtime::connections() const {
+		std::lock_guard __l{mutex_};
+		return open_.size();
+	}
+
+	void server_runtime::serve_(const std::shared_ptr<connection_>& c) {
+		try {
+			// accepted after stop() shut the others down, or woken by the shutdown
+			if (stopping_)
+				return end_(c);
+			c->idle = true;
+			auto __request = c->endpoint->fetch();
+			c->idle = false;
+			if (!__request)
+				// closed by the peer or by stop(), or a malformed request already answered
+				return end_(c);
+			response __response;
+			try {
+				__response = handler_(*__request);
+			} catch (const std::exception&) {
+				__response = {{}, status::internal_error, {}};
+			}
+			const bool __close = stopping_ || wants_close(__request->headers);
+			if (__close)
+				__response.headers.set("connection", "close");
+			if (!__response.headers.contains("content-length") && !__response.headers.contains("transfer-encoding"))
+				__response.headers.set("content-length", std::to_string(__response.content.size()));
+			c->endpoint->send(__response);
+			if (__close)
+				return end_(c);
+		} catch (const std::exception&) {
+			return end_(c);
+		}
+		if (c->socket == invalid_socket || c->endpoint->buffered())
+			return pool_.defer([this, c] {
+				serve_(c);
+			});
+		park_(c);
+	}
+
+	void server_runtime::park_(const std::shared_ptr<connection_>& c) {
+#ifdef PLATFORM_Linux
+		loop_.post([this, c] {
+			// a socket that is readable already, or shut down by stop(), is reported at once
+			loop_.add(c->socket, EPOLLIN | EPOLLRDHUP, [this, c](std::uint32_t) {
+				loop_.remove(c->socket);
+				pool_.submit([this, c] {
+					serve_(c);
+				});
+			});
+		});
+#else
+		pool_.defer([this, c] {
+			serve_(c);
+		});
+#endif
+	}
+
+	void server_runtime::end_(const std::shared_ptr<connection_>& c) {
+		// under the lock, so stop() never shuts down a closed socket
+		std::lock_guard __l{mutex_};
+		c->endpoint->close();
+		open_.erase(c);
+		ended_.notify_all();
+	}
+}
@@ -1,5 +1,7 @@
 #include "http1_1/server.h"
 #include "http1_1/common.h"
+#include "http1_1/parser.h"
+#include <array>
 
 namespace network::http {
 
@@ -12,52 +14,89 @@ namespace network::http {
 	}
 
 	std::expected<request, request_parse_error> serverside_endpoint::fetch() {
-		const auto req_l = base_->read_line();
-		if (req_l.back() != '\r' || base_->read() != '\n') {
-			send_error_(request_parse_error::invalid_line_folding);
-			return std::unexpected{request_parse_error::invalid_line_folding};
-		}
-		const auto ws1 = req_l.find(' ');
-		if (ws1 == std::string::npos) {
-			send_error_(request_parse_error::request_line_missing_space);
-			return std::unexpected{request_parse_error::request_line_missing_space};
-		}
-		const auto ws2 = req_l.find(' ', ws1 + 1);
-		if (ws2 == std::string::npos) {
-			send_error_(request_parse_error::request_line_missing_space);
-			return std::unexpected{request_parse_error::request_line_missing_space};
+		auto __r = fetch_head();
+		if (!__r)
+			return __r;
+		auto content_r = read_message_content(reader_, __r->headers, message_type::request);
+		if (!content_r) {
+			send_error_(request_parse_error::message_content_error);
+			return std::unexpected{request_parse_error::message_content_error};
 		}
-		request __r;
-		__r.method = req_l.substr(0, ws1);
+		__r->content = std::move(content_r.value());
+		return __r;
+	}
+
+	std::expected<request, request_parse_error> serverside_endpoint::fetch_head() {
+		const auto __head = fetch_head_view();
+		if (!__head)
+			return std::unexpected{__head.error()};
+		uri target;
 		try {
-			__r.target = uri::from(req_l.substr(ws1 + 1, ws2 - ws1 - 1));
+			target = uri::from((*__head)->target);
 		} catch (...) {
 			send_error_(request_parse_error::invalid_request_target);
 			return std::unexpected{request_parse_error::invalid_request_target};
 		}
-		auto field_r = fields::from_http_headers(*base_);
-		if (!field_r) {
-			send_error_(request_parse_error::invalid_header_fields);
-			return std::unexpected{request_parse_error::invalid_header_fields};
-		}
-		__r.headers = std::move(field_r.value());
-		auto content_r = read_message_content(*base_, __r.headers, message_type::request);
-		if (!content_r) {
-			send_error_(request_parse_error::message_content_error);
-			return std::unexpected{request_parse_error::message_content_error};
-		}
-		__r.content = std::move(content_r.value());
+		// constructed rather than assigned, so the fields keep their allocator
+		request __r{std::string((*__head)->method), std::move(target), (*__head)->to_fields(resource)};
+		reader_.consume(std::exchange(head_length_, 0));
 		return __r;
 	}
 
+	std::expected<const request_head_view*, request_parse_error> serverside_endpoint::fetch_head_view() {
+		reader_.consume(std::exchange(head_length_, 0));
+		auto& __head = head_.emplace(resource);
+		const auto __length = read_head(reader_, __head, max_head_size);
+		if (!__length && __length.error() == head_parse_error::incomplete && !reader_.buffered())
+			// closed between requests
+			return std::unexpected{request_parse_error::invalid_line_folding};
+		if (!__length) {
+			const auto __e = __length.error() == head_parse_error::head_too_large
+				? request_parse_error::header_fields_too_large
+				: __head.method.data()
+				? request_parse_error::invalid_header_fields
+				: __length.error() == head_parse_error::missing_space
+				? request_parse_error::request_line_missing_space
+				: request_parse_error::invalid_line_folding;
+			send_error_(__e);
+			return std::unexpected{__e};
+		}
+		head_length_ = __length.value();
+		return &__head;
+	}
+
+	std::pmr::string serverside_endpoint::format_head_(const response& __r) const {
+		std::pmr::string __head{resource};
+		std::format_to(std::back_inserter(__head), "HTTP/1.1 {} \r\n", static_cast<std::uint16_t>(__r.code));
+		__r.headers.format_to(std::back_inserter(__head));
+		return __head;
+	}
+
 	void serverside_endpoint::send(const response& __r) {
-		const auto res = std::format(
-			"HTTP/1.1 {} \r\n{}\r\n{}",
-			static_cast<std::uint16_t>(__r.code), static_cast<std::string>(__r.headers), __r.content);
-		base_->write(reinterpret_cast<const byte_string&>(res));
+		auto __head = format_head_(__r);
+		__head += "\r\n";
+		const std::array<byte_string_view, 2> __buffers{
+			byte_string_view{reinterpret_cast<const std::uint8_t*>(__head.data()), __head.size()},
+			reinterpret_cast<const byte_string&>(__r.content)};
+		base_->write(__buffers);
+	}
+
+	void serverside_endpoint::send_file(const response& head, const int fd, const std::uint64_t offset, const std::size_t length) {
+		auto __head = format_head_(head);
+		if (!head.headers.contains("content-length"))
+			std::format_to(std::back_inserter(__head), "content-length: {}\r\n", length);
+		__head += "\r\n";
+		// the head goes out in the same segment as the start of the file
+		cork_guard __g{*base_};
+		base_->write(byte_string_view{reinterpret_cast<const std::uint8_t*>(__head.data()), __head.size()});
+		if (base_->send_file(fd, offset, length) != length)
+			throw std::runtime_error("send_file: file ended before the announced length");
 	}
 
 	void serverside_endpoint::send_error_(const request_parse_error error) {
+		// message framing is lost after a malformed request
+		reader_.clear();
+		head_length_ = 0;
 		switch (error) {
 			case request_parse_error::invalid_line_folding:
 				send_as_html_(status::bad_request, "invalid line folding in request message");
@@ -71,6 +110,9 @@ namespace network::http {
 			case request_parse_error::invalid_header_fields:
 				send_as_html_(status::bad_request, "invalid request headers");
 				break;
+			case request_parse_error::header_fields_too_large:
+				send_as_html_(status::request_header_fields_too_large, "request headers too large");
+				break;
 			default:
 				send_as_html_(status::internal_error, "server internal error");
 				throw std::runtime_error("unimplemented");
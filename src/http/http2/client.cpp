@@ -14,8 +14,12 @@ namespace network::http2 {
 		client_.connect(host, port);
 		connected_host_ = host;
 		connected_port_ = port;
-		client_.write(preface);
-		state_.write(settings(state_.pack_local_settings()));
+		{
+			// the preface and SETTINGS leave together
+			cork_guard __g{client_};
+			client_.write(preface);
+			state_.write(settings(state_.pack_local_settings()));
+		}
 		const auto parse_result = parse_frame(client_);
 		if (!parse_result)
 			throw connection_error(error_t::protocol_error, "first frame must be SETTINGS");
@@ -1,6 +1,7 @@
 #include "http2/frame.h"
 #include "http2/state.h"
 #include "internal/utils.h"
+#include <array>
 #include <format>
 
 using namespace internal;
@@ -141,11 +142,13 @@ namespace network::http2 {
 			if (const auto available = __h.available_window()) {
 				const auto fragment = fragments.substr(0, available);
 				fragments.remove_prefix(fragment.size());
-				write(std::endian::big, __s, fragment.length(), 3);
-				write(std::endian::big, __s, frame_type_t::data);
-				write(std::endian::big, __s, end_stream && fragments.empty() ? 1 : 0, 1);
-				write(std::endian::big, __s, stream_id);
-				__s.write(fragments);
+				byte_string __head;
+				write(std::endian::big, __head, fragment.length(), 3);
+				write(std::endian::big, __head, frame_type_t::data);
+				write(std::endian::big, __head, end_stream && fragments.empty() ? 1 : 0, 1);
+				write(std::endian::big, __head, stream_id);
+				const std::array<byte_string_view, 2> __buffers{__head, fragment};
+				__s.write(__buffers);
 			} else
 				co_await std::suspend_always();
 		}
@@ -198,13 +201,15 @@ namespace network::http2 {
 				__flags.padded = __copy.padding.has_value();
 				__flags.end_stream = __copy.end_stream;
 			}
-			write(std::endian::big, __s, __f.size(), 3);
-			write(std::endian::big, __s, first_frame ? frame_type_t::headers : frame_type_t::continuation);
-			write(std::endian::big, __s, __flags);
-			write(std::endian::big, __s, __copy.stream_id);
+			byte_string __head;
+			write(std::endian::big, __head, __f.size(), 3);
+			write(std::endian::big, __head, first_frame ? frame_type_t::headers : frame_type_t::continuation);
+			write(std::endian::big, __head, __flags);
+			write(std::endian::big, __head, __copy.stream_id);
 			if (__copy.priority)
-				write(std::endian::big, __s, __copy.priority.value());
-			__s.write(__f);
+				write(std::endian::big, __head, __copy.priority.value());
+			const std::array<byte_string_view, 2> __buffers{__head, __f};
+			__s.write(__buffers);
 		}
 		co_return;
 	}
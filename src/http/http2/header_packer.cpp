@@ -107,19 +107,15 @@ namespace network::http2 {
 		shrink_();
 	}
 
-	template<class T1, class T2, class U1, class U2>
-	constexpr bool operator==(const std::pair<T1, T2>& lhs, const std::pair<U1, U2>& rhs) {
-		return lhs.first == rhs.first && lhs.second == rhs.second;
-	}
-
 	byte_string header_packer::encode(const http::fields& headers) {
 		byte_string ret;
 		for (auto& pair: headers) {
-			auto& [name, value] = pair;
+			const std::string_view name = pair.first, value = pair.second;
+			const auto same = [&](auto& lhs){ return lhs.first == name && lhs.second == value; };
 			const auto [ind, indexed] = [&] -> std::pair<std::uintmax_t, bool> {
-				if (const auto it = std::ranges::find_if(static_header_pairs, [&](auto& lhs){ return lhs == pair; }); it != static_header_pairs.end())
+				if (const auto it = std::ranges::find_if(static_header_pairs, same); it != static_header_pairs.end())
 					return {static_cast<std::uintmax_t>(std::distance(static_header_pairs.begin(), it)), true};
-				if (const auto it = std::ranges::find_if(dynamic_header_pairs, [&](auto& lhs){ return lhs == pair; }); it != dynamic_header_pairs.end())
+				if (const auto it = std::ranges::find_if(dynamic_header_pairs, same); it != dynamic_header_pairs.end())
 					return {static_cast<std::uintmax_t>(std::distance(dynamic_header_pairs.begin(), it) + 62), true};
 				const auto static_keys = static_header_pairs | std::views::keys;
 				if (const auto it = std::ranges::find(static_keys, name); it != static_keys.end())
@@ -139,12 +135,12 @@ namespace network::http2 {
 			if (ind == 0) {
 				ret.push_back(0);
 				write_integer(ret, 7, name.size());
-				ret += reinterpret_cast<const byte_string&>(name);
+				ret += byte_string_view{reinterpret_cast<const std::uint8_t*>(name.data()), name.size()};
 			}
 			ret.push_back(0);
 			write_integer(ret, 7, value.size());
-			ret += reinterpret_cast<const byte_string&>(value);
-			emplace_front_(name, value);
+			ret += byte_string_view{reinterpret_cast<const std::uint8_t*>(value.data()), value.size()};
+			emplace_front_(std::string{name}, std::string{value});
 		}
 		return ret;
 	}
@@ -2,8 +2,11 @@
 #include <expected>
 
 #include "basic_stream.h"
+#include "buffered_stream.h"
 #include "http/uri.h"
+#include <iterator>
 #include <map>
+#include <memory_resource>
 #include <format>
 
 namespace network::http {
@@ -12,10 +15,14 @@ namespace network::http {
 
 		struct field_name_less {
 
-			bool operator()(const std::string&, const std::string&) const;
+			/// Lookups by `std::string_view` or a literal do not build a key first.
+			using is_transparent = void;
+
+			bool operator()(std::string_view, std::string_view) const;
 		};
 
-		using field_base = std::map<std::string, std::string, field_name_less>;
+		/// Nodes, names and values are all allocated from the map's resource, e.g. an `arena`.
+		using field_base = std::pmr::map<std::pmr::string, std::pmr::string, field_name_less>;
 	}
 
 	enum class field_parse_error {
@@ -26,17 +33,32 @@ namespace network::http {
 
 		using internal::field_base::map;
 
-		std::string& append(std::string_view name, std::string_view value, std::string_view sep = ",");
+		std::pmr::string& append(std::string_view name, std::string_view value, std::string_view sep = ",");
 
-		std::string& set(std::string_view name, std::string_view value);
+		std::pmr::string& set(std::string_view name, std::string_view value);
 
 		void remove(std::string_view name);
 
 		operator std::string() const;
 
+		/// Writes one `name: value\r\n` line per field to `out`.
+		template<std::output_iterator<char> Out>
+		Out format_to(Out out) const {
+			for (auto& [field, value]: *this)
+				out = std::format_to(out, "{}: {}\r\n", field, value);
+			return out;
+		}
+
 		static std::expected<fields, field_parse_error> from_http_headers(istream&);
 
+		/// Parses lines in place from the buffer instead of reading them octet by octet; the fields are allocated from `__m`.
+		static std::expected<fields, field_parse_error> from_http_headers(
+			buffered_stream&, std::pmr::memory_resource* __m = std::pmr::get_default_resource());
+
 		static fields from_event_stream(istream&);
+
+	private:
+		[[nodiscard]] std::pmr::string lower_key_(std::string_view name) const;
 	};
 
 	enum class message_type {
@@ -45,7 +67,8 @@ namespace network::http {
 
 
 	enum class status: std::uint16_t {
-		no_content = 204, not_modified = 304, bad_request = 400, internal_error = 500
+		no_content = 204, not_modified = 304, bad_request = 400, request_header_fields_too_large = 431,
+		internal_error = 500
 	};
 
 	inline bool informational(const status code) {
@@ -0,0 +1,315 @@
+#pragma once
+#include "stream_endpoint.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <utility>
+
+namespace network::http {
+
+	/// What a pooled connection leads to; connections are only shared between equal origins.
+	struct origin {
+
+		std::string scheme, host;
+
+		tcp_port_t port{};
+
+		/// Tells TLS configurations of one host apart (client certificate, ALPN, ...); empty for plain connections.
+		std::string tls_profile;
+
+		auto operator<=>(const origin&) const = default;
+	};
+
+	/**
+	 * \brief Thread-safe pool of client connections, keyed by origin.
+	 *
+	 * Connections are created by a factory, lent out through `lease`s and kept idle once returned, for at most
+	 * `idle_timeout`. An idle connection is health-checked before it is lent again. At most `max_per_origin`
+	 * connections to one origin are lent at a time; further `acquire()` calls wait for one to come back. Leases must
+	 * not outlive the pool.
+	 */
+	class connection_pool {
+	public:
+		using clock = std::chrono::steady_clock;
+
+		/// Creates a connection to the origin, already connected.
+		using factory = std::function<std::unique_ptr<stream_client>(const origin&)>;
+
+		/// Whether an idle connection is still usable, e.g. the peer has not closed it meanwhile.
+		using health_check = std::function<bool(stream_client&)>;
+
+		/// A borrowed connection, returned to the pool on destruction unless discarded.
+		class lease {
+		public:
+			lease(lease&& other) noexcept
+				: pool_(std::exchange(other.pool_, nullptr)), origin_(std::move(other.origin_)),
+				  connection_(std::move(other.connection_)) {
+			}
+
+			lease& operator=(lease&& other) noexcept {
+				if (this != &other) {
+					release_();
+					pool_ = std::exchange(other.pool_, nullptr);
+					origin_ = std::move(other.origin_);
+					connection_ = std::move(other.connection_);
+				}
+				return *this;
+			}
+
+			~lease() {
+				release_();
+			}
+
+			stream_client& operator*() const {
+				return *connection_;
+			}
+
+			stream_client* operator->() const {
+				return connection_.get();
+			}
+
+			[[nodiscard]] const origin& destination() const {
+				return origin_;
+			}
+
+			/// Closes the connection instead of returning it, e.g. after a protocol error or `Connection: close`.
+			void discard() {
+				if (connection_)
+					connection_->close();
+			}
+
+		private:
+			friend connection_pool;
+
+			lease(connection_pool& pool, origin o, std::unique_ptr<stream_client> c)
+				: pool_(&pool), origin_(std::move(o)), connection_(std::move(c)) {
+			}
+
+			connection_pool* pool_;
+
+			origin origin_;
+
+			std::unique_ptr<stream_client> connection_;
+
+			void release_() {
+				if (pool_)
+					pool_->release_(origin_, std::move(connection_));
+				pool_ = nullptr;
+			}
+		};
+
+		explicit connection_pool(factory f, const std::size_t max_per_origin = 6,
+				const clock::duration idle_timeout = std::chrono::seconds(30),
+				health_check check = [](stream_client& c) { return c.alive(); })
+			: factory_(std::move(f)), check_(std::move(check)), max_per_origin_(max_per_origin),
+			  idle_timeout_(idle_timeout) {
+		}
+
+		connection_pool(const connection_pool&) = delete;
+
+		connection_pool& operator=(const connection_pool&) = delete;
+
+		/// Lends the most recently used healthy idle connection to `o`, or a new one.
+		lease acquire(const origin& o) {
+			std::unique_lock __l{mutex_};
+			auto& __s = slots_[o];
+			while (true) {
+				evict_(__s, clock::now());
+				if (!__s.idle.empty()) {
+					auto __c = std::move(__s.idle.back().connection);
+					__s.idle.pop_back();
+					++__s.lent;
+					__l.unlock();
+					if (check_(*__c))
+						return {*this, o, std::move(__c)};
+					__c->close();
+					__l.lock();
+					--__s.lent;
+					continue;
+				}
+				if (__s.lent < max_per_origin_) {
+					++__s.lent;
+					__l.unlock();
+					try {
+						return {*this, o, factory_(o)};
+					} catch (...) {
+						__l.lock();
+						--__s.lent;
+						released_.notify_one();
+						throw;
+					}
+				}
+				released_.wait(__l);
+			}
+		}
+
+		/// Closes idle connections that have exceeded the idle timeout; `acquire()` does so for its own origin.
+		void evict_expired() {
+			std::lock_guard __l{mutex_};
+			const auto __now = clock::now();
+			for (auto& __s: slots_ | std::views::values)
+				evict_(__s, __now);
+		}
+
+		[[nodiscard]] std::size_t idle(const origin& o) const {
+			std::lock_guard __l{mutex_};
+			const auto __it = slots_.find(o);
+			return __it == slots_.end() ? 0 : __it->second.idle.size();
+		}
+
+		[[nodiscard]] std::size_t lent(const origin& o) const {
+			std::lock_guard __l{mutex_};
+			const auto __it = slots_.find(o);
+			return __it == slots_.end() ? 0 : __it->second.lent;
+		}
+
+	private:
+		struct idle_connection {
+
+			std::unique_ptr<stream_client> connection;
+
+			clock::time_point since;
+		};
+
+		struct slot {
+
+			/// Oldest first.
+			std::deque<idle_connection> idle;
+
+			std::size_t lent = 0;
+		};
+
+		factory factory_;
+
+		health_check check_;
+
+		std::size_t max_per_origin_;
+
+		clock::duration idle_timeout_;
+
+		mutable std::mutex mutex_;
+
+		std::condition_variable released_;
+
+		std::map<origin, slot> slots_;
+
+		void evict_(slot& s, const clock::time_point now) const {
+			while (!s.idle.empty() && now - s.idle.front().since >= idle_timeout_) {
+				s.idle.front().connection->close();
+				s.idle.pop_front();
+			}
+		}
+
+		void release_(const origin& o, std::unique_ptr<stream_client> c) {
+			{
+				std::lock_guard __l{mutex_};
+				auto& __s = slots_[o];
+				--__s.lent;
+				if (c && c->connected())
+					__s.idle.push_back({std::move(c), clock::now()});
+			}
+			released_.notify_one();
+		}
+	};
+
+	/**
+	 * \brief Client endpoint that borrows its connection from a `connection_pool`.
+	 *
+	 * `connect()` hands the current connection back to the pool and borrows one to the new origin, so a client
+	 * alternating between origins reuses its connections; `close()` discards the current one. It can stand in for the
+	 * connection of `http::client` or `http2::client`.
+	 */
+	class pooled_client final: public stream_client {
+	public:
+		explicit pooled_client(connection_pool& pool, std::string scheme = "http", std::string tls_profile = {})
+			: pool_(pool), scheme_(std::move(scheme)), tls_profile_(std::move(tls_profile)) {
+		}
+
+		void connect(const std::string_view host, const tcp_port_t port) override {
+			lease_.reset();
+			lease_.emplace(pool_.acquire({scheme_, std::string(host), port, tls_profile_}));
+		}
+
+		/// Returns the current connection to the pool.
+		void release() {
+			lease_.reset();
+		}
+
+		[[nodiscard]] bool connected() const override {
+			return lease_ && (*lease_)->connected();
+		}
+
+		[[nodiscard]] bool alive() const override {
+			return lease_ && (*lease_)->alive();
+		}
+
+		void close() override {
+			if (lease_)
+				lease_->discard();
+			lease_.reset();
+		}
+
+		void finish() override {
+			get_().finish();
+		}
+
+		std::size_t available() override {
+			return get_().available();
+		}
+
+		std::uint8_t read() override {
+			return get_().read();
+		}
+
+		byte_string read(const std::size_t count) override {
+			return get_().read(count);
+		}
+
+		std::size_t read_some(const std::span<std::uint8_t> buffer) override {
+			return get_().read_some(buffer);
+		}
+
+		void read_exact(const std::span<std::uint8_t> buffer) override {
+			get_().read_exact(buffer);
+		}
+
+		void skip(const std::size_t count) override {
+			get_().skip(count);
+		}
+
+		void write(const std::uint8_t octet) override {
+			get_().write(octet);
+		}
+
+		void write(const byte_string_view data) override {
+			get_().write(data);
+		}
+
+		void write(const std::span<const byte_string_view> buffers) override {
+			get_().write(buffers);
+		}
+
+		void cork(const bool enable) override {
+			get_().cork(enable);
+		}
+
+	private:
+		connection_pool& pool_;
+
+		std::string scheme_, tls_profile_;
+
+		std::optional<connection_pool::lease> lease_;
+
+		stream_client& get_() const {
+			if (!lease_)
+				throw std::runtime_error("pooled client not connected");
+			return **lease_;
+		}
+	};
+}
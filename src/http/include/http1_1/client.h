@@ -1,26 +1,137 @@
 #pragma once
 #include "stream_endpoint.h"
 #include "http/message.h"
+#include "buffered_stream.h"
+#include "http1_1/common.h"
+#include <deque>
+#include <future>
 
 namespace network::http {
 
 	struct client {
 
 		explicit client(stream_client& c, const bool secured)
-			: base_(c), secured_(secured) {
+			: base_(c), secured_(secured), reader_(c) {
 		}
 
 		response fetch(request);
 
+		/**
+		 * \brief Sends `req` and reads the head of the response, leaving the content to be streamed through `body()`.
+		 *
+		 * Redirections are not followed; throws `client_error` if no valid response head arrives.
+		 */
+		response fetch_head(const request& req);
+
+		/// Reader of the content of `head`, the response last returned by `fetch_head()`.
+		body_reader body(const response& head);
+
+		/**
+		 * \brief Like `fetch_head()`, but returns the head as parsed in place, copying nothing out of the read buffer.
+		 *
+		 * The view is valid until the next request, or until the content is read through `body()`.
+		 */
+		const response_head_view& fetch_head_view(const request& req);
+
+		/// Reader of the content of `head`, the view last returned by `fetch_head_view()`, which it invalidates.
+		body_reader body(const response_head_view& head);
+
+		/**
+		 * \brief Queues an idempotent request for `flush()`; its response, or the error, arrives through the future.
+		 *
+		 * Redirections are not followed. Throws `std::invalid_argument` for methods that are not idempotent, since
+		 * those cannot be sent again after a connection fails.
+		 */
+		std::future<response> pipeline(request);
+
+		/**
+		 * \brief Sends the queued requests and reads their responses.
+		 *
+		 * Consecutive requests to one origin are written back to back and answered in order over one connection.
+		 * Requests left unanswered when the server closes the connection, with `Connection: close` or by dropping
+		 * it, even within a response, are sent again on a new connection; one that has already been resent then fails
+		 * instead.
+		 */
+		void flush();
+
+		/// Largest response head accepted, status line included; a larger one fails with `client_error`.
+		std::size_t max_head_size = 64 * 1024;
+
+		/**
+		 * \brief Memory for request heads and the header fields of received responses.
+		 *
+		 * May point to an `arena` that the caller resets between requests, once the previous response is destroyed.
+		 */
+		std::pmr::memory_resource* resource = std::pmr::get_default_resource();
+
 	private:
 		stream_client& base_;
 
 		const bool secured_;
 
+		/// Buffers responses read from `base_`; kept across requests on the same connection.
+		buffered_stream reader_;
+
 		std::string connected_host_;
 
 		tcp_port_t connected_port_{};
 
+		struct pipelined_ {
+
+			request req;
+
+			std::promise<response> promise;
+
+			/// Sent again after a connection failed.
+			bool retried = false;
+		};
+
+		/// Requests queued by `pipeline()`, oldest first.
+		std::deque<pipelined_> pipeline_;
+
 		void connect_(std::string_view host, tcp_port_t port);
+
+		static tcp_port_t port_(const uri&);
+
+		void format_head_(const request&, std::pmr::string&) const;
+
+		/// Method of the request last sent by `fetch_head()`.
+		std::string head_method_;
+
+		/// Whether the content of the last response was read to its end, leaving the connection reusable.
+		bool body_finished_ = true;
+
+		/// Head last read, parsed in place in `reader_`.
+		std::optional<response_head_view> head_;
+
+		/// Octets of `head_` left in `reader_`, consumed once the view is no longer needed.
+		std::size_t head_length_ = 0;
+
+		/// Sends `req` and reads the head of its response into `head_`.
+		const response_head_view& send_and_read_head_(const request& req);
+
+		/// Reads a response head into `head_`; throws `client_error` if the connection ends or the head is malformed.
+		const response_head_view& read_head_view_();
+
+		/// Reads a response head; throws `client_error` if the connection ends or the head is malformed.
+		response read_head_();
+
+		/// Reads the whole response to `req`; throws `client_error` if the connection ends or the response is malformed.
+		response read_response_(const request& req);
+
+		/**
+		 * \brief Reads the whole content of `res`, a response to a `method` request, into it.
+		 * \return False if the connection ended within the content, which is kept as far as it arrived.
+		 */
+		bool read_content_(response& res, std::string_view method);
+
+		/// Reader of the content of `res`, a response to a `method` request.
+		body_reader body_(const response& res, std::string_view method);
+
+		/// Reader of the content of `head`, a response to a `method` request.
+		body_reader body_(const response_head_view& head, std::string_view method);
+
+		/// Whether a `code` response to a `method` request has no content, whatever its fields say.
+		static bool without_content_(status code, std::string_view method);
 	};
 }
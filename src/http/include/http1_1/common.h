@@ -1,13 +1,159 @@
 #pragma once
 #include "stream_endpoint.h"
 #include "http/message.h"
+#include "http1_1/parser.h"
+#include <concepts>
+#include <functional>
+#include <optional>
+#include <span>
+#include <utility>
 
 namespace network::http {
 
 	enum class message_body_parse_error {
-		invalid_chunk_line_folding, invalid_chunk_size, invalid_content_length, cannot_determine_length
+		invalid_chunk_line_folding, invalid_chunk_size, invalid_content_length, cannot_determine_length,
+		/// The stream ended within a body delimited by Content-Length or by chunked encoding.
+		content_truncated
 	};
 
+	/**
+	 * \brief Reads a message body piece by piece, as it arrives.
+	 *
+	 * The framing (Content-Length, chunked, or until the connection closes) is taken from the header fields, and
+	 * chunked encoding is decoded incrementally, so memory use is bounded by the stream's buffer rather than the
+	 * body. Nothing is read before the caller asks for it, so a slow consumer holds the sender back through the
+	 * transport's flow control. A body abandoned before its end leaves the connection unusable for further messages;
+	 * `discard()` skips the rest instead.
+	 */
+	class body_reader final {
+	public:
+		/// An empty body, e.g. of a response to HEAD; `finished`, if given, is set once the end is read.
+		explicit body_reader(buffered_stream& source, bool* finished = nullptr)
+			: source_(&source), finished_(finished) {
+		}
+
+		body_reader(buffered_stream& source, const fields&, message_type, bool* finished = nullptr);
+
+		/**
+		 * \brief Framed by the fields of a head parsed in place, which are only looked at here.
+		 *
+		 * A template, so that `{}` for the fields still means no fields.
+		 */
+		template<std::derived_from<head_view> Head>
+		body_reader(buffered_stream& source, const Head& head, const message_type t, bool* finished = nullptr)
+			: source_(&source), finished_(finished) {
+			frame_(head, t);
+		}
+
+		body_reader(body_reader&& other) noexcept
+			: source_(other.source_), state_(other.state_), remaining_(other.remaining_), error_(other.error_),
+			  pending_(std::exchange(other.pending_, 0)), finished_(other.finished_) {
+		}
+
+		body_reader& operator=(body_reader&&) = delete;
+
+		~body_reader() {
+			source_->consume(pending_);
+		}
+
+		/**
+		 * \brief The next piece of the body, at most `max` (> 0) octets, without copying it out of the stream's buffer.
+		 * \return A view valid until the next call; empty at the end of the body.
+		 */
+		std::expected<byte_string_view, message_body_parse_error> next(std::size_t max = std::string::npos);
+
+		/// Copies the next piece of the body into `buffer`; returns its length, 0 at the end of the body.
+		std::expected<std::size_t, message_body_parse_error> read_some(std::span<std::uint8_t> buffer);
+
+		/**
+		 * \brief Passes every piece of the body to `on_data` until the end, or until it returns false.
+		 * \return Whether the end of the body was reached.
+		 */
+		std::expected<bool, message_body_parse_error> read_all(const std::function<bool(byte_string_view)>& on_data);
+
+		/// Skips the rest of the body, keeping the connection usable.
+		std::expected<void, message_body_parse_error> discard();
+
+		/// Whether the whole body has been read.
+		[[nodiscard]] bool done() const {
+			return state_ == state::done && !error_;
+		}
+
+		/// Octets left of a body with a Content-Length.
+		[[nodiscard]] std::optional<std::size_t> remaining() const {
+			if (state_ == state::length)
+				return remaining_;
+			if (state_ == state::done)
+				return 0;
+			return std::nullopt;
+		}
+
+	private:
+		enum class state {
+			done, length, until_close, chunk_size, chunk_data, trailers
+		};
+
+		buffered_stream* source_;
+
+		state state_ = state::done;
+
+		/// Octets left of the body or of the current chunk.
+		std::size_t remaining_ = 0;
+
+		std::optional<message_body_parse_error> error_;
+
+		/// Octets of the last view returned, consumed on the next call so the view stays valid until then.
+		std::size_t pending_ = 0;
+
+		/// Set once the end of the body is read, so the owner of the stream knows the next message starts there.
+		bool* finished_ = nullptr;
+
+		/// Picks the framing from the Transfer-Encoding and Content-Length values, where present.
+		void frame_(std::optional<std::string_view> transfer_encoding, std::optional<std::string_view> content_length,
+			message_type);
+
+		void frame_(const head_view&, message_type);
+
+		byte_string_view take_(std::size_t max);
+
+		std::unexpected<message_body_parse_error> fail_(message_body_parse_error);
+	};
+
+	/**
+	 * \brief Reads from `source` until it holds a whole message head, and parses it into `head`; nothing is consumed.
+	 *
+	 * After the first attempt the head is parsed again only once its closing empty line has arrived, looked for in
+	 * the octets read since the last look, so a head arriving in many pieces costs linear time.
+	 * \return The length of the head; `head_parse_error::incomplete` if the stream ends first, and
+	 * `head_parse_error::head_too_large` if `limit` octets arrive without the whole head.
+	 */
+	template<typename Head>
+	std::expected<std::size_t, head_parse_error> read_head(buffered_stream& source, Head& head, const std::size_t limit) {
+		std::size_t __searched = 0;
+		for (bool __ended = false;;) {
+			const auto __b = source.peek(source.buffered());
+			const std::string_view __s{reinterpret_cast<const char*>(__b.data()), __b.size()};
+			// back up over the part of the empty line that may have arrived before
+			if (__ended || !__searched || __s.find("\r\n\r\n", __searched < 3 ? 0 : __searched - 3) != std::string_view::npos) {
+				const auto __r = head.parse(__s);
+				if (__r && __r.value() > limit)
+					return std::unexpected{head_parse_error::head_too_large};
+				if (__r || __r.error() != head_parse_error::incomplete || __ended)
+					return __r;
+			}
+			if (__s.size() >= limit)
+				return std::unexpected{head_parse_error::head_too_large};
+			__searched = __s.size();
+			__ended = !source.fill();
+		}
+	}
+
+	/**
+	 * \brief Reads a whole message body into memory.
+	 *
+	 * A response body cut short by the end of the stream is returned as far as it arrived; a request body cut short
+	 * is `message_body_parse_error::content_truncated`.
+	 */
 	std::expected<std::string, message_body_parse_error>
-	read_message_content(stream_endpoint&, const fields&, message_type);
+	read_message_content(buffered_stream&, const fields&, message_type);
 }
@@ -0,0 +1,246 @@
+#pragma once
+#include "http/message.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cctype>
+#include <charconv>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace network::http {
+
+	namespace internal {
+
+		/// Position of the first octet in [p, end) equal to one of `C`, or `end`; compares 16 or 32 octets at a time.
+		template<char... C>
+		const char* scan(const char* p, const char* const end) {
+#ifdef __AVX2__
+			for (; end - p >= 32; p += 32) {
+				const auto __v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+				if (const auto __m = static_cast<std::uint32_t>(
+						(_mm256_movemask_epi8(_mm256_cmpeq_epi8(__v, _mm256_set1_epi8(C))) | ...)))
+					return p + std::countr_zero(__m);
+			}
+#endif
+#ifdef __SSE2__
+			for (; end - p >= 16; p += 16) {
+				const auto __v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+				if (const auto __m = static_cast<std::uint32_t>(
+						(_mm_movemask_epi8(_mm_cmpeq_epi8(__v, _mm_set1_epi8(C))) | ...)))
+					return p + std::countr_zero(__m);
+			}
+#endif
+			for (; p != end; ++p)
+				if (((*p == C) || ...))
+					return p;
+			return end;
+		}
+
+		/// Compares field names, which are case-insensitive.
+		inline bool iequals(const std::string_view a, const std::string_view b) {
+			return std::ranges::equal(a, b, [](const unsigned char x, const unsigned char y) {
+				return std::tolower(x) == std::tolower(y);
+			});
+		}
+
+		constexpr std::string_view trim_whitespace(std::string_view s) {
+			while (!s.empty() && (s.front() == ' ' || s.front() == '\t'))
+				s.remove_prefix(1);
+			while (!s.empty() && (s.back() == ' ' || s.back() == '\t'))
+				s.remove_suffix(1);
+			return s;
+		}
+	}
+
+	enum class head_parse_error {
+		/// The buffer ends before the empty line closing the head; parse again once more data has arrived.
+		incomplete,
+		invalid_line_folding, missing_space, invalid_status_code, obsolete_line_folding, missing_colon,
+		invalid_whitespace_after_name,
+		/// More octets than the reader allows arrived without the empty line closing the head.
+		head_too_large
+	};
+
+	/// A header field pointing into the parsed buffer.
+	struct field_view {
+
+		std::string_view name, value;
+	};
+
+	/**
+	 * \brief Header fields of a message head parsed in place.
+	 *
+	 * Names and values are views into the parsed buffer, valid while it is; nothing is copied or lowercased, and
+	 * repeated fields are kept apart. `to_fields()` builds owned `fields` when they are needed after all. The first
+	 * `inline_fields` fields are kept in place, and all of them move to memory from `resource` past that.
+	 */
+	class head_view {
+	public:
+		static constexpr std::size_t inline_fields = 32;
+
+		explicit head_view(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+			: spilled_(resource) {
+		}
+
+		/// Octets of the head, up to and including the empty line; the content starts there.
+		std::size_t length = 0;
+
+		[[nodiscard]] std::span<const field_view> fields() const {
+			if (count_ > inline_fields)
+				return spilled_;
+			return {fields_.data(), count_};
+		}
+
+		/// Value of the first field named `name`, compared case-insensitively.
+		[[nodiscard]] std::optional<std::string_view> field(const std::string_view name) const {
+			for (const auto& __f: fields())
+				if (internal::iequals(__f.name, name))
+					return __f.value;
+			return std::nullopt;
+		}
+
+		/// Owned copy of the fields, with lowercase names and repeated fields combined.
+		[[nodiscard]] http::fields to_fields(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const {
+			http::fields __f{resource};
+			for (const auto& [__name, __value]: fields())
+				__f.append(__name, __value);
+			return __f;
+		}
+
+	protected:
+		std::array<field_view, inline_fields> fields_;
+
+		/// Every field once there are more than `inline_fields`.
+		std::pmr::vector<field_view> spilled_;
+
+		std::size_t count_ = 0;
+
+		void add_(const field_view f) {
+			if (count_ < inline_fields)
+				fields_[count_] = f;
+			else {
+				if (count_ == inline_fields)
+					spilled_.assign(fields_.begin(), fields_.end());
+				spilled_.push_back(f);
+			}
+			++count_;
+		}
+
+		/// Finds the line starting at `begin`; returns where it ends, at its CR.
+		static std::expected<const char*, head_parse_error> line_end_(const char* const begin, const char* const end) {
+			const auto __p = internal::scan<'\r', '\n'>(begin, end);
+			if (end - __p < 2)
+				return std::unexpected{head_parse_error::incomplete};
+			if (__p[0] != '\r' || __p[1] != '\n')
+				return std::unexpected{head_parse_error::invalid_line_folding};
+			return __p;
+		}
+
+		/// Parses field lines and the closing empty line from `p`; returns the length of the head.
+		std::expected<std::size_t, head_parse_error> parse_fields_(const char* p, const std::string_view buffer) {
+			const auto __end = buffer.data() + buffer.size();
+			count_ = 0;
+			spilled_.clear();
+			while (true) {
+				if (__end - p < 2)
+					return std::unexpected{head_parse_error::incomplete};
+				if (p[0] == '\r' || p[0] == '\n') {
+					if (p[0] != '\r' || p[1] != '\n')
+						return std::unexpected{head_parse_error::invalid_line_folding};
+					length = p + 2 - buffer.data();
+					return length;
+				}
+				if (p[0] == ' ' || p[0] == '\t')
+					return std::unexpected{head_parse_error::obsolete_line_folding};
+				// one pass finds the colon, or the line end of a field without one
+				const auto __colon = internal::scan<':', '\r', '\n'>(p, __end);
+				if (__colon == __end)
+					return std::unexpected{head_parse_error::incomplete};
+				if (*__colon != ':') {
+					const auto __e = line_end_(__colon, __end);
+					return std::unexpected{__e ? head_parse_error::missing_colon : __e.error()};
+				}
+				if (__colon == p || __colon[-1] == ' ' || __colon[-1] == '\t')
+					return std::unexpected{head_parse_error::invalid_whitespace_after_name};
+				const auto __line_end = line_end_(__colon + 1, __end);
+				if (!__line_end)
+					return std::unexpected{__line_end.error()};
+				add_({{p, __colon}, internal::trim_whitespace({__colon + 1, __line_end.value()})});
+				p = __line_end.value() + 2;
+			}
+		}
+	};
+
+	/// Request line and header fields, parsed in place.
+	struct request_head_view final: head_view {
+
+		using head_view::head_view;
+
+		/// Set once the request line has been parsed, so an error with `method.data()` null is in the request line.
+		std::string_view method, target, version;
+
+		/**
+		 * \brief Parses the head at the start of `buffer` in a single pass.
+		 * \return The length of the head; `head_parse_error::incomplete` if `buffer` does not hold all of it yet.
+		 */
+		std::expected<std::size_t, head_parse_error> parse(const std::string_view buffer) {
+			method = target = version = {};
+			const auto __begin = buffer.data(), __end = __begin + buffer.size();
+			const auto __line_end = line_end_(__begin, __end);
+			if (!__line_end)
+				return std::unexpected{__line_end.error()};
+			const std::string_view __line{__begin, __line_end.value()};
+			const auto __ws1 = __line.find(' ');
+			if (__ws1 == std::string_view::npos)
+				return std::unexpected{head_parse_error::missing_space};
+			const auto __ws2 = __line.find(' ', __ws1 + 1);
+			if (__ws2 == std::string_view::npos)
+				return std::unexpected{head_parse_error::missing_space};
+			method = __line.substr(0, __ws1);
+			target = __line.substr(__ws1 + 1, __ws2 - __ws1 - 1);
+			version = __line.substr(__ws2 + 1);
+			return parse_fields_(__line_end.value() + 2, buffer);
+		}
+	};
+
+	/// Status line and header fields, parsed in place.
+	struct response_head_view final: head_view {
+
+		using head_view::head_view;
+
+		std::string_view version, reason;
+
+		status code{};
+
+		/// \copydoc request_head_view::parse
+		std::expected<std::size_t, head_parse_error> parse(const std::string_view buffer) {
+			const auto __begin = buffer.data(), __end = __begin + buffer.size();
+			const auto __line_end = line_end_(__begin, __end);
+			if (!__line_end)
+				return std::unexpected{__line_end.error()};
+			const std::string_view __line{__begin, __line_end.value()};
+			if (!__line.starts_with("HTTP/"))
+				return std::unexpected{head_parse_error::invalid_status_code};
+			const auto __ws1 = __line.find(' ', 5);
+			if (__ws1 == std::string_view::npos)
+				return std::unexpected{head_parse_error::missing_space};
+			// the reason phrase may be missing along with the space before it
+			const auto __ws2 = std::min(__line.find(' ', __ws1 + 1), __line.size());
+			version = __line.substr(0, __ws1);
+			reason = __line.substr(std::min(__ws2 + 1, __line.size()));
+			std::uint16_t __code;
+			const auto __c = __line.data() + __ws1 + 1, __c_end = __line.data() + __ws2;
+			if (__c_end - __c != 3 || std::from_chars(__c, __c_end, __code).ptr != __c_end)
+				return std::unexpected{head_parse_error::invalid_status_code};
+			code = static_cast<status>(__code);
+			return parse_fields_(__line_end.value() + 2, buffer);
+		}
+	};
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include "http1_1/server.h"
+#include "tcp/reactor.h"
+#include "thread_pool.h"
+#include <chrono>
+#include <unordered_set>
+
+namespace network::http {
+
+	/**
+	 * \brief Serves the connections of a `server` on a work-stealing `thread_pool`.
+	 *
+	 * `run()` accepts connections on the calling thread and submits one task per connection, which fetches a request,
+	 * passes it to the handler and sends the response. Connections are persistent unless the request asks for
+	 * `Connection: close`. Between requests a socket connection waits on a `tcp::reactor` rather than on a worker and
+	 * is submitted again once readable, so idle keep-alive clients do not starve new ones; a connection with a
+	 * pipelined request already buffered, or over another transport, defers its task instead, occupying a worker
+	 * while it waits.
+	 */
+	class server_runtime final {
+	public:
+		/// Produces the response to a request; an exception is answered with 500 Internal Server Error.
+		using handler = std::function<response(const request&)>;
+
+		server_runtime(server& s, handler h, std::size_t workers = std::max(1u, std::thread::hardware_concurrency()));
+
+		server_runtime(const server_runtime&) = delete;
+
+		server_runtime& operator=(const server_runtime&) = delete;
+
+		~server_runtime();
+
+		/// Accepts connections on the listening server until `stop()`.
+		void run();
+
+		/**
+		 * \brief Stops accepting, answers the requests in flight and waits for every connection to end.
+		 *
+		 * Reading is shut down on every connection at once, so no task waits for a request that may never come;
+		 * requests already read are answered with `Connection: close`. Connections still open after `grace`, e.g.
+		 * with a response blocked on a client that does not read, are shut down altogether.
+		 */
+		void stop(std::chrono::milliseconds grace = std::chrono::seconds(5));
+
+		/// Connections currently open.
+		[[nodiscard]] std::size_t connections() const;
+
+	private:
+		struct connection_;
+
+		server& server_;
+
+		handler handler_;
+
+		std::atomic<bool> stopping_ = false;
+
+		mutable std::mutex mutex_;
+
+		std::condition_variable ended_;
+
+		std::unordered_set<std::shared_ptr<connection_>> open_;
+
+#ifdef PLATFORM_Linux
+		/// Watches connections between requests; runs on `poller_`.
+		tcp::reactor loop_;
+
+		std::thread poller_;
+#endif
+
+		/// Destroyed first, so no task outlives the members it uses.
+		thread_pool pool_;
+
+		void serve_(const std::shared_ptr<connection_>&);
+
+		/// Hands the connection back to the pool once its next request starts to arrive.
+		void park_(const std::shared_ptr<connection_>&);
+
+		void end_(const std::shared_ptr<connection_>&);
+	};
+}
@@ -1,6 +1,7 @@
 #pragma once
 #include "stream_endpoint.h"
 #include "http/message.h"
+#include "http1_1/common.h"
 #include <expected>
 
 namespace network::http {
@@ -29,19 +30,48 @@ namespace network::http {
 
 	enum class request_parse_error {
 		invalid_line_folding, request_line_missing_space, invalid_request_target, invalid_header_fields,
-		message_content_error
+		message_content_error, header_fields_too_large
 	};
 
 	struct serverside_endpoint final: basic_endpoint {
 
 		explicit serverside_endpoint(std::unique_ptr<stream_endpoint> __b)
-			: base_(std::move(__b)) {
+			: base_(std::move(__b)), reader_(*base_) {
 		}
 
 		std::expected<request, request_parse_error> fetch();
 
+		/// Like `fetch()`, but leaves the content unread, to be streamed through `body()`.
+		std::expected<request, request_parse_error> fetch_head();
+
+		/**
+		 * \brief Like `fetch_head()`, but returns the head as parsed in place, copying nothing out of the read buffer.
+		 *
+		 * The view is valid until the next fetch, or until the content is read through `body()`. Its target is
+		 * passed on unchecked; malformed heads are answered as by `fetch()`.
+		 */
+		std::expected<const request_head_view*, request_parse_error> fetch_head_view();
+
+		/// Reader of the content of `head`, the request last returned by `fetch_head()`.
+		body_reader body(const request& head) {
+			return {reader_, head.headers, message_type::request};
+		}
+
+		/// Reader of the content of `head`, the view last returned by `fetch_head_view()`, which it invalidates.
+		body_reader body(const request_head_view& head) {
+			body_reader __b{reader_, head, message_type::request};
+			reader_.consume(std::exchange(head_length_, 0));
+			return __b;
+		}
+
 		void send(const response&);
 
+		/**
+		 * \brief Sends `head` with `length` octets of the file `fd` from `offset` as the body, leaving the copying to
+		 * the transport (`sendfile` on TCP); `head.content` is ignored and a missing Content-Length is added.
+		 */
+		void send_file(const response& head, int fd, std::uint64_t offset, std::size_t length);
+
 		[[nodiscard]] bool connected() const override {
 			return base_->connected();
 		}
@@ -58,9 +88,36 @@ namespace network::http {
 			return *base_;
 		}
 
+		/// Octets read ahead of the requests fetched so far, e.g. a pipelined request.
+		[[nodiscard]] std::size_t buffered() const {
+			return reader_.buffered();
+		}
+
+		/// Largest request head accepted, request line included; a larger one is answered with 431.
+		std::size_t max_head_size = 64 * 1024;
+
+		/**
+		 * \brief Memory for the header fields of fetched requests and the heads of sent responses.
+		 *
+		 * Pointing it to an `arena` that the caller resets once a request is answered keeps request processing off
+		 * the global heap; fetched requests must then be destroyed, or copied, before the reset.
+		 */
+		std::pmr::memory_resource* resource = std::pmr::get_default_resource();
+
 	private:
 		const std::unique_ptr<stream_endpoint> base_;
 
+		/// Buffers requests read from `base_`, so pipelined requests are not lost between `fetch()` calls.
+		buffered_stream reader_;
+
+		/// Head last fetched, parsed in place in `reader_`.
+		std::optional<request_head_view> head_;
+
+		/// Octets of `head_` left in `reader_`, consumed once the view is no longer needed.
+		std::size_t head_length_ = 0;
+
+		std::pmr::string format_head_(const response&) const;
+
 		void send_error_(request_parse_error);
 
 		void send_as_html_(status, std::string_view);
@@ -0,0 +1,79 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+/**
+ * \brief Scratch memory for objects that live no longer than one request on a connection.
+ *
+ * Allocations are carved from one block with a bump pointer, deallocation does nothing, and `reset()` reclaims
+ * everything at once. Memory needed beyond the block comes from the global heap, and the block is enlarged by that
+ * much on the next `reset()`, so a connection serving similar requests stops allocating after the first few.
+ */
+class arena final: public std::pmr::memory_resource {
+
+	/// Upstream of `resource_`, counting what did not fit into the block.
+	struct overflow_resource final: std::pmr::memory_resource {
+
+		std::size_t requested = 0;
+
+		void* do_allocate(const std::size_t bytes, const std::size_t alignment) override {
+			requested += bytes;
+			return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+		}
+
+		void do_deallocate(void* p, const std::size_t bytes, const std::size_t alignment) override {
+			std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+		}
+
+		[[nodiscard]] bool do_is_equal(const memory_resource& other) const noexcept override {
+			return this == &other;
+		}
+	};
+
+	std::size_t size_;
+
+	std::unique_ptr<std::byte[]> block_;
+
+	overflow_resource overflow_;
+
+	std::optional<std::pmr::monotonic_buffer_resource> resource_;
+
+	void* do_allocate(const std::size_t bytes, const std::size_t alignment) override {
+		return resource_->allocate(bytes, alignment);
+	}
+
+	void do_deallocate(void*, std::size_t, std::size_t) override {
+	}
+
+	[[nodiscard]] bool do_is_equal(const memory_resource& other) const noexcept override {
+		return this == &other;
+	}
+
+public:
+	explicit arena(const std::size_t size = 1 << 14)
+		: size_(size), block_(std::make_unique_for_overwrite<std::byte[]>(size)) {
+		resource_.emplace(block_.get(), size_, &overflow_);
+	}
+
+	arena(const arena&) = delete;
+
+	arena& operator=(const arena&) = delete;
+
+	/// Size of the block that allocations are served from before falling back to the global heap.
+	[[nodiscard]] std::size_t capacity() const {
+		return size_;
+	}
+
+	/// Reclaims all allocations; everything allocated from the arena must have been destroyed already.
+	void reset() {
+		resource_.reset();
+		if (overflow_.requested) {
+			size_ += overflow_.requested;
+			block_ = std::make_unique_for_overwrite<std::byte[]>(size_);
+			overflow_.requested = 0;
+		}
+		resource_.emplace(block_.get(), size_, &overflow_);
+	}
+};
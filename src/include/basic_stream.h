@@ -1,17 +1,24 @@
 #pragma once
 #include "byte_string.h"
 #include <algorithm>
+#include <cerrno>
+#include <format>
+#include <span>
 #include <stdexcept>
 
+#ifdef PLATFORM_Windows
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
 struct istream {
 
 	virtual std::uint8_t read() = 0;
 
 	virtual byte_string read(const std::size_t count) {
-		byte_string str;
-		str.reserve(count);
-		for (std::size_t i = 0; i < count; ++i)
-			str.push_back(read());
+		byte_string str(count, 0);
+		read_exact(str);
 		return str;
 	}
 
@@ -30,6 +37,24 @@ struct istream {
 		read(count);
 	}
 
+	/// Reads at least one octet, unless `buffer` is empty or the stream has ended; returns the number of octets read.
+	virtual std::size_t read_some(const std::span<std::uint8_t> buffer) {
+		if (buffer.empty())
+			return 0;
+		buffer[0] = read();
+		return 1;
+	}
+
+	/// Fills `buffer` completely; throws `std::runtime_error` if the stream ends first.
+	virtual void read_exact(const std::span<std::uint8_t> buffer) {
+		for (std::size_t __n = 0; __n < buffer.size(); ) {
+			const auto __r = read_some(buffer.subspan(__n));
+			if (!__r)
+				throw std::runtime_error("unexpected end of stream");
+			__n += __r;
+		}
+	}
+
 	virtual ~istream() = default;
 };
 
@@ -43,10 +68,77 @@ struct ostream {
 			write(c);
 	}
 
+	/// Writes `buffers` back to back, so that callers need not concatenate them first.
+	virtual void write(const std::span<const byte_string_view> buffers) {
+		for (const auto buffer: buffers)
+			write(buffer);
+	}
+
+	/**
+	 * \brief Writes `length` octets of the file `fd` from `offset` (from the current position for pipes).
+	 * \return The number of octets written, fewer than `length` only if the file ends first.
+	 *
+	 * The default copies through a user-space buffer; endpoints that can have the kernel move the data override it.
+	 */
+	virtual std::size_t send_file(const int fd, const std::uint64_t offset, const std::size_t length) {
+		std::uint8_t __buffer[1 << 16];
+		std::size_t __sent = 0;
+		while (__sent < length) {
+			const auto __want = std::min(length - __sent, sizeof __buffer);
+#ifdef PLATFORM_Windows
+			if (_lseeki64(fd, offset + __sent, SEEK_SET) < 0)
+				throw std::runtime_error(std::format("_lseeki64 gives error {}", errno));
+			const auto __n = _read(fd, __buffer, static_cast<unsigned>(__want));
+#else
+			auto __n = pread(fd, __buffer, __want, offset + __sent);
+			if (__n < 0 && errno == ESPIPE)
+				__n = ::read(fd, __buffer, __want);
+			if (__n < 0 && errno == EINTR)
+				continue;
+#endif
+			if (__n < 0)
+				throw std::runtime_error(std::format("read gives error {}", errno));
+			if (__n == 0)
+				break;
+			write(byte_string_view{__buffer, static_cast<std::size_t>(__n)});
+			__sent += __n;
+		}
+		return __sent;
+	}
+
+	/// While corked, writes may be held back and coalesced until uncorked; does nothing unless overridden.
+	virtual void cork(bool) {
+	}
+
 	virtual ~ostream() = default;
 };
 
 
+/// Corks a stream for the lifetime of the guard, e.g. around a flush made of several writes.
+class cork_guard {
+
+	ostream& stream_;
+
+public:
+	explicit cork_guard(ostream& s)
+		: stream_(s) {
+		stream_.cork(true);
+	}
+
+	cork_guard(const cork_guard&) = delete;
+
+	cork_guard& operator=(const cork_guard&) = delete;
+
+	~cork_guard() {
+		try {
+			stream_.cork(false);
+		} catch (...) {
+			// the stream failed meanwhile; the error surfaces on its next use
+		}
+	}
+};
+
+
 struct stream: virtual istream, virtual ostream {
 };
 
@@ -69,6 +161,19 @@ struct string_stream: virtual stream, virtual byte_string {
 		return str;
 	}
 
+	std::size_t read_some(const std::span<std::uint8_t> buffer) override {
+		const auto n = std::min(buffer.size(), size());
+		std::copy_n(begin(), n, buffer.begin());
+		erase(0, n);
+		return n;
+	}
+
+	void read_exact(const std::span<std::uint8_t> buffer) override {
+		if (size() < buffer.size())
+			throw std::runtime_error("empty buffer");
+		read_some(buffer);
+	}
+
 	void write(const std::uint8_t octet) override {
 		push_back(octet);
 	}
@@ -76,4 +181,9 @@ struct string_stream: virtual stream, virtual byte_string {
 	void write(const byte_string_view data) override {
 		append(data);
 	}
+
+	void write(const std::span<const byte_string_view> buffers) override {
+		for (const auto buffer: buffers)
+			append(buffer);
+	}
 };
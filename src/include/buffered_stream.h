@@ -0,0 +1,155 @@
+#pragma once
+#include "basic_stream.h"
+#include <cstring>
+#include <optional>
+
+/**
+ * \brief Read buffer over an `istream`.
+ *
+ * The source is read in blocks of up to `block_size` octets through `read_some()`, so line-oriented parsing costs one
+ * read per block rather than one per octet. Views returned by `peek()` and `read_until()` stay valid until the next
+ * non-const call.
+ */
+class buffered_stream final: public istream {
+
+	istream& source_;
+
+	byte_string buffer_;
+
+	/// Start of unconsumed data in `buffer_`.
+	std::size_t begin_ = 0;
+
+	std::size_t block_size_;
+
+	/// Returns the offset of the first of `a` or `b` in the unconsumed data at or after `from`.
+	[[nodiscard]] std::optional<std::size_t> find_(const std::uint8_t a, const std::uint8_t b, const std::size_t from) const {
+		const auto __data = buffer_.data() + begin_ + from;
+		const auto __size = buffered() - from;
+		const auto __pa = static_cast<const std::uint8_t*>(std::memchr(__data, a, __size));
+		const auto __pb = a == b ? nullptr : static_cast<const std::uint8_t*>(std::memchr(__data, b, __pa ? __pa - __data : __size));
+		const auto __p = __pb ? __pb : __pa;
+		if (!__p)
+			return std::nullopt;
+		return from + (__p - __data);
+	}
+
+public:
+	explicit buffered_stream(istream& source, const std::size_t block_size = 4096)
+		: source_(source), block_size_(block_size) {
+	}
+
+	/// Number of octets read from the source but not consumed yet.
+	[[nodiscard]] std::size_t buffered() const {
+		return buffer_.size() - begin_;
+	}
+
+	/// Reads one block from the source; returns the number of octets added, 0 at the end of the stream.
+	std::size_t fill() {
+		if (begin_ && (begin_ >= buffer_.size() / 2 || buffer_.size() + block_size_ > buffer_.capacity())) {
+			buffer_.erase(0, begin_);
+			begin_ = 0;
+		}
+		const auto __old = buffer_.size();
+		buffer_.resize(__old + block_size_);
+		const auto __n = source_.read_some({buffer_.data() + __old, block_size_});
+		buffer_.resize(__old + __n);
+		return __n;
+	}
+
+	/// Buffers at least `count` octets unless the stream ends first; the result may be shorter than `count`.
+	byte_string_view peek(const std::size_t count) {
+		while (buffered() < count)
+			if (!fill())
+				break;
+		return byte_string_view{buffer_}.substr(begin_, count);
+	}
+
+	/// Discards `count` buffered octets.
+	void consume(const std::size_t count) {
+		if (count > buffered())
+			throw std::out_of_range{"buffered_stream: consuming more than buffered"};
+		begin_ += count;
+		if (begin_ == buffer_.size()) {
+			buffer_.clear();
+			begin_ = 0;
+		}
+	}
+
+	/**
+	 * \brief Consumes and returns everything up to and including `delim`.
+	 * \return `std::nullopt` if the stream ends, or `limit` octets pass, before `delim` is found; nothing is consumed.
+	 */
+	std::optional<byte_string_view> read_until(const std::uint8_t delim, const std::size_t limit = std::string::npos) {
+		std::size_t __searched = 0;
+		for (;;) {
+			if (const auto __pos = find_(delim, delim, __searched)) {
+				if (__pos.value() >= limit)
+					return std::nullopt;
+				const auto __r = byte_string_view{buffer_}.substr(begin_, __pos.value() + 1);
+				begin_ += __pos.value() + 1;
+				return __r;
+			}
+			__searched = buffered();
+			if (__searched >= limit || !fill())
+				return std::nullopt;
+		}
+	}
+
+	/// Drops buffered data, e.g. after the source reconnected.
+	void clear() {
+		buffer_.clear();
+		begin_ = 0;
+	}
+
+	std::uint8_t read() override {
+		if (!buffered() && !fill())
+			throw std::runtime_error{"buffered_stream: end of stream"};
+		const auto __c = buffer_[begin_];
+		consume(1);
+		return __c;
+	}
+
+	/// Reads exactly `count` octets; throws if the stream ends first. `read_some()` and `peek()` return short reads.
+	byte_string read(const std::size_t count) override {
+		byte_string __r{peek(count)};
+		if (__r.size() < count)
+			throw std::runtime_error{"buffered_stream: end of stream"};
+		consume(count);
+		return __r;
+	}
+
+	std::size_t read_some(const std::span<std::uint8_t> buffer) override {
+		if (!buffered()) {
+			// large reads bypass the buffer
+			if (buffer.size() >= block_size_)
+				return source_.read_some(buffer);
+			if (!fill())
+				return 0;
+		}
+		const auto __n = std::min(buffer.size(), buffered());
+		std::memcpy(buffer.data(), buffer_.data() + begin_, __n);
+		consume(__n);
+		return __n;
+	}
+
+	std::string read_line() override {
+		std::size_t __searched = 0;
+		for (;;) {
+			if (const auto __pos = find_('\r', '\n', __searched)) {
+				std::string __r{reinterpret_cast<const char*>(buffer_.data() + begin_), __pos.value() + 1};
+				consume(__pos.value() + 1);
+				return __r;
+			}
+			__searched = buffered();
+			if (!fill())
+				throw std::runtime_error{"buffered_stream: end of stream"};
+		}
+	}
+
+	/// Skips exactly `count` octets; throws if the stream ends first, with the rest still buffered.
+	void skip(const std::size_t count) override {
+		if (peek(count).size() < count)
+			throw std::runtime_error{"buffered_stream: end of stream"};
+		consume(count);
+	}
+};
@@ -10,7 +10,7 @@ void hash_combine(std::size_t& seed, const T& v) noexcept {
 template<class K, class V>
 struct std::hash<std::pair<K, V>> {
 
-	std::size_t operator()(const std::pair<K, V>& __v) {
+	std::size_t operator()(const std::pair<K, V>& __v) const {
 		std::size_t __r{};
 		hash_combine(__r, __v.first);
 		hash_combine(__r, __v.second);
@@ -21,7 +21,7 @@ struct std::hash<std::pair<K, V>> {
 template<class T> requires std::ranges::range<T>
 struct std::hash<T> {
 
-	std::size_t operator()(const T& __v) {
+	std::size_t operator()(const T& __v) const {
 		std::size_t __r{};
 		for (const auto& __i: __v)
 			hash_combine(__r, __i);
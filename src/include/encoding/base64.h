@@ -1,6 +1,7 @@
 #pragma once
 #include "byte_string.h"
 #include <cctype>
+#include <functional>
 
 namespace encoding::base64 {
 
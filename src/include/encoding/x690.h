@@ -19,7 +19,7 @@ namespace encoding::x690 {
 	enum class tag_t: std::size_t {
 		end_of_content = 0, boolean = 1, integer = 2, bitstring = 3, octetstring = 4, null = 5, object_id = 6,
 		object_descriptor = 7, external = 8, real = 9, enumerated = 10, embedded_pdv = 11, utf8_string = 12,
-		sequence = 16, set = 17, generalized_time = 23, utc_time = 24, visible_string = 26
+		sequence = 16, set = 17, utc_time = 23, generalized_time = 24, visible_string = 26
 	};
 
 
@@ -0,0 +1,145 @@
+#pragma once
+#include "basic_stream.h"
+#include <cstring>
+#include <deque>
+
+/**
+ * \brief FIFO byte buffer made of a queue of chunks.
+ *
+ * Reading advances an offset into the first chunk and drops chunks once drained, so consuming data costs O(1) per
+ * chunk instead of shifting the whole buffer as `string_stream` does. Whole strings passed to `append(byte_string&&)`
+ * become chunks without being copied. Views returned by `front()` stay valid until the next non-const call.
+ */
+class io_buffer final: public stream {
+
+	std::deque<byte_string> chunks_;
+
+	/// Octets already consumed from the first chunk.
+	std::size_t head_ = 0;
+
+	std::size_t size_ = 0;
+
+	std::size_t chunk_size_;
+
+	void pop_front_() {
+		if (chunks_.size() == 1)
+			// keep the last chunk's storage for reuse
+			chunks_.front().clear();
+		else
+			chunks_.pop_front();
+		head_ = 0;
+	}
+
+public:
+	explicit io_buffer(const std::size_t chunk_size = 1 << 14)
+		: chunk_size_(chunk_size) {
+	}
+
+	[[nodiscard]] std::size_t size() const {
+		return size_;
+	}
+
+	[[nodiscard]] bool empty() const {
+		return size_ == 0;
+	}
+
+	/// The longest contiguous run of unread octets, i.e. the rest of the first chunk.
+	[[nodiscard]] byte_string_view front() const {
+		if (empty())
+			return {};
+		return byte_string_view{chunks_.front()}.substr(head_);
+	}
+
+	/// Discards the first `count` unread octets.
+	void consume(std::size_t count) {
+		if (count > size_)
+			throw std::out_of_range{"io_buffer: consuming more than buffered"};
+		size_ -= count;
+		while (count) {
+			const auto __n = std::min(count, chunks_.front().size() - head_);
+			head_ += __n;
+			count -= __n;
+			if (head_ == chunks_.front().size())
+				pop_front_();
+		}
+	}
+
+	/// Copies `data` to the end, filling the last chunk before starting a new one.
+	void append(byte_string_view data) {
+		size_ += data.size();
+		while (!data.empty()) {
+			if (chunks_.empty() || chunks_.back().size() == chunks_.back().capacity())
+				chunks_.emplace_back().reserve(std::max(chunk_size_, data.size()));
+			auto& __back = chunks_.back();
+			const auto __n = std::min(data.size(), __back.capacity() - __back.size());
+			__back.append(data.substr(0, __n));
+			data.remove_prefix(__n);
+		}
+	}
+
+	/// Takes `data` over as a chunk of its own.
+	void append(byte_string&& data) {
+		if (data.empty())
+			return;
+		size_ += data.size();
+		if (!chunks_.empty() && chunks_.back().empty())
+			chunks_.back() = std::move(data);
+		else
+			chunks_.push_back(std::move(data));
+	}
+
+	void clear() {
+		chunks_.clear();
+		head_ = size_ = 0;
+	}
+
+	std::uint8_t read() override {
+		if (empty())
+			throw std::runtime_error("empty buffer");
+		const auto c = chunks_.front()[head_];
+		consume(1);
+		return c;
+	}
+
+	/// Reads up to `count` octets; fewer if less is buffered.
+	byte_string read(const std::size_t count) override {
+		byte_string str(std::min(count, size_), 0);
+		read_some(str);
+		return str;
+	}
+
+	std::size_t read_some(const std::span<std::uint8_t> buffer) override {
+		const auto n = std::min(buffer.size(), size_);
+		for (std::size_t __copied = 0; __copied < n; ) {
+			const auto __f = front();
+			const auto __m = std::min(n - __copied, __f.size());
+			std::memcpy(buffer.data() + __copied, __f.data(), __m);
+			consume(__m);
+			__copied += __m;
+		}
+		return n;
+	}
+
+	void read_exact(const std::span<std::uint8_t> buffer) override {
+		if (size_ < buffer.size())
+			throw std::runtime_error("empty buffer");
+		read_some(buffer);
+	}
+
+	void skip(const std::size_t count) override {
+		consume(std::min(count, size_));
+	}
+
+	void write(const std::uint8_t octet) override {
+		append(byte_string_view{&octet, 1});
+	}
+
+	void write(const byte_string_view data) override {
+		append(data);
+	}
+
+	void write(const std::span<const byte_string_view> buffers) override {
+		for (const auto buffer: buffers)
+			append(buffer);
+	}
+};
@@ -9,6 +9,12 @@ namespace network {
 	};
 
 	struct stream_client: virtual stream_endpoint, virtual basic_client {
+
+		/// Whether the connection is still usable, checked without blocking; transports that can tell detect a peer
+		/// that has closed it, the rest only report `connected()`.
+		[[nodiscard]] virtual bool alive() const {
+			return connected();
+		}
 	};
 
 	struct stream_server: virtual basic_server {
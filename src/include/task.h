@@ -0,0 +1,165 @@
+#pragma once
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+namespace network {
+
+	template<class T>
+	class task;
+
+	namespace internal {
+
+		template<class T>
+		struct task_promise_base {
+
+			std::coroutine_handle<> continuation;
+
+			std::exception_ptr exception;
+
+			/// Resumes whoever awaited the task, by symmetric transfer so long chains do not grow the stack.
+			struct final_awaiter {
+
+				bool await_ready() const noexcept {
+					return false;
+				}
+
+				template<class P>
+				std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) const noexcept {
+					if (const auto __c = h.promise().continuation)
+						return __c;
+					return std::noop_coroutine();
+				}
+
+				void await_resume() const noexcept {}
+			};
+
+			std::suspend_always initial_suspend() const noexcept {
+				return {};
+			}
+
+			final_awaiter final_suspend() const noexcept {
+				return {};
+			}
+
+			void unhandled_exception() {
+				exception = std::current_exception();
+			}
+
+			void rethrow_() const {
+				if (exception)
+					std::rethrow_exception(exception);
+			}
+		};
+
+		template<class T>
+		struct task_promise: task_promise_base<T> {
+
+			std::optional<T> value;
+
+			task<T> get_return_object();
+
+			template<class U>
+			void return_value(U&& u) {
+				value.emplace(std::forward<U>(u));
+			}
+
+			T result_() {
+				this->rethrow_();
+				return std::move(*value);
+			}
+		};
+
+		template<>
+		struct task_promise<void>: task_promise_base<void> {
+
+			task<void> get_return_object();
+
+			void return_void() {}
+
+			void result_() const {
+				rethrow_();
+			}
+		};
+	}
+
+	/**
+	 * \brief Lazily started coroutine producing a `T`.
+	 *
+	 * Awaiting a task starts it and suspends the awaiter until it finishes; its result or exception is then handed
+	 * over. A top-level task is started with `start()` and driven by whatever event loop its awaitables registered
+	 * with, until `done()`.
+	 */
+	template<class T = void>
+	class [[nodiscard]] task {
+	public:
+		using promise_type = internal::task_promise<T>;
+
+		task(task&& other) noexcept
+			: handle_(std::exchange(other.handle_, {})) {
+		}
+
+		task& operator=(task&& other) noexcept {
+			if (this != &other) {
+				if (handle_)
+					handle_.destroy();
+				handle_ = std::exchange(other.handle_, {});
+			}
+			return *this;
+		}
+
+		~task() {
+			if (handle_)
+				handle_.destroy();
+		}
+
+		/// Runs the coroutine until its first suspension point.
+		void start() {
+			handle_.resume();
+		}
+
+		[[nodiscard]] bool done() const {
+			return handle_.done();
+		}
+
+		/// Result of a finished task; rethrows what escaped the coroutine.
+		T get() {
+			return handle_.promise().result_();
+		}
+
+		bool await_ready() const noexcept {
+			return false;
+		}
+
+		std::coroutine_handle<> await_suspend(const std::coroutine_handle<> awaiter) noexcept {
+			handle_.promise().continuation = awaiter;
+			return handle_;
+		}
+
+		T await_resume() {
+			return handle_.promise().result_();
+		}
+
+	private:
+		friend promise_type;
+
+		explicit task(const std::coroutine_handle<promise_type> handle)
+			: handle_(handle) {
+		}
+
+		std::coroutine_handle<promise_type> handle_;
+	};
+
+	namespace internal {
+
+		template<class T>
+		task<T> task_promise<T>::get_return_object() {
+			return task<T>{std::coroutine_handle<task_promise>::from_promise(*this)};
+		}
+
+		inline task<void> task_promise<void>::get_return_object() {
+			return task<void>{std::coroutine_handle<task_promise>::from_promise(*this)};
+		}
+	}
+}
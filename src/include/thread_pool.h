@@ -0,0 +1,161 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace network {
+
+	/**
+	 * \brief Fixed set of worker threads balancing tasks by work stealing.
+	 *
+	 * Every worker has its own deque: a task submitted from a worker goes to the back of that worker's deque and is
+	 * taken from the back (newest first, while its data is still in cache), whereas an idle worker steals from the
+	 * front of another worker's deque (oldest first). Tasks submitted from other threads are spread round-robin. Tasks
+	 * must not throw.
+	 */
+	class thread_pool final {
+	public:
+		using job = std::function<void()>;
+
+		explicit thread_pool(const std::size_t workers = std::max(1u, std::thread::hardware_concurrency()))
+			: queues_(workers) {
+			threads_.reserve(workers);
+			for (std::size_t i = 0; i < workers; ++i)
+				threads_.emplace_back([this, i] {
+					run_(i);
+				});
+		}
+
+		thread_pool(const thread_pool&) = delete;
+
+		thread_pool& operator=(const thread_pool&) = delete;
+
+		/// Runs the tasks still queued, then stops the workers.
+		~thread_pool() {
+			{
+				std::lock_guard __l{sleep_mutex_};
+				stopping_ = true;
+			}
+			wake_.notify_all();
+			for (auto& __t: threads_)
+				__t.join();
+		}
+
+		void submit(job j) {
+			push_(std::move(j), false);
+		}
+
+		/**
+		 * \brief Like `submit()`, but a worker runs the task after the others in its deque rather than next; for a
+		 * long-lived task that re-submits itself and should not starve the rest.
+		 */
+		void defer(job j) {
+			push_(std::move(j), true);
+		}
+
+		[[nodiscard]] std::size_t size() const {
+			return queues_.size();
+		}
+
+		/// Tasks taken from another worker's deque so far.
+		[[nodiscard]] std::size_t steals() const {
+			return steals_;
+		}
+
+	private:
+		struct queue_ {
+
+			std::mutex mutex;
+
+			std::deque<job> jobs;
+		};
+
+		std::vector<queue_> queues_;
+
+		std::vector<std::thread> threads_;
+
+		std::mutex sleep_mutex_;
+
+		std::condition_variable wake_;
+
+		/// Tasks in all deques; workers sleep while it is 0.
+		std::size_t queued_ = 0;
+
+		bool stopping_ = false;
+
+		std::atomic<std::size_t> next_ = 0, steals_ = 0;
+
+		/// Pool and deque of the worker running on this thread, if any.
+		static inline thread_local const thread_pool* current_ = nullptr;
+
+		static inline thread_local std::size_t current_index_ = 0;
+
+		void push_(job j, const bool front) {
+			const auto __index = current_ == this ? current_index_ : next_++ % queues_.size();
+			{
+				std::lock_guard __l{queues_[__index].mutex};
+				if (front)
+					queues_[__index].jobs.push_front(std::move(j));
+				else
+					queues_[__index].jobs.push_back(std::move(j));
+			}
+			{
+				// counted under the sleep mutex, so a worker about to sleep sees it
+				std::lock_guard __l{sleep_mutex_};
+				++queued_;
+			}
+			wake_.notify_one();
+		}
+
+		void run_(const std::size_t index) {
+			current_ = this;
+			current_index_ = index;
+			while (true) {
+				{
+					std::unique_lock __l{sleep_mutex_};
+					wake_.wait(__l, [this] { return queued_ || stopping_; });
+					if (!queued_)
+						return;
+				}
+				if (auto __j = take_(index))
+					__j();
+			}
+		}
+
+		job take_(const std::size_t index) {
+			{
+				auto& __q = queues_[index];
+				std::lock_guard __l{__q.mutex};
+				if (!__q.jobs.empty()) {
+					auto __j = std::move(__q.jobs.back());
+					__q.jobs.pop_back();
+					taken_();
+					return __j;
+				}
+			}
+			for (std::size_t i = 1; i < queues_.size(); ++i) {
+				auto& __q = queues_[(index + i) % queues_.size()];
+				std::lock_guard __l{__q.mutex};
+				if (!__q.jobs.empty()) {
+					auto __j = std::move(__q.jobs.front());
+					__q.jobs.pop_front();
+					taken_();
+					++steals_;
+					return __j;
+				}
+			}
+			// another worker took it first
+			return {};
+		}
+
+		void taken_() {
+			std::lock_guard __l{sleep_mutex_};
+			--queued_;
+		}
+	};
+}
@@ -0,0 +1,184 @@
+#pragma once
+#include "task.h"
+#include "tcp/client.h"
+#include "tcp/server.h"
+#include "tcp/reactor.h"
+
+#ifdef PLATFORM_Linux
+
+namespace network::tcp {
+
+	/**
+	 * \brief Suspends the awaiting coroutine until `socket` reports one of `events`.
+	 *
+	 * The socket is registered with the reactor for this single wait, so it must not be registered otherwise.
+	 */
+	struct readiness {
+
+		reactor& loop;
+
+		socket_t socket;
+
+		std::uint32_t events;
+
+		bool await_ready() const noexcept {
+			return false;
+		}
+
+		void await_suspend(const std::coroutine_handle<> h) const {
+			loop.add(socket, events, [&__loop = loop, __s = socket, h](std::uint32_t) {
+				__loop.remove(__s);
+				h.resume();
+			});
+		}
+
+		void await_resume() const noexcept {}
+	};
+
+	/**
+	 * \brief Awaitable operations on a connected endpoint, resumed by a reactor.
+	 *
+	 * The endpoint is switched to non-blocking mode and stays registered with the reactor while this object lives.
+	 * One read and one write may be outstanding at a time.
+	 */
+	class async_endpoint final {
+	public:
+		async_endpoint(reactor& loop, endpoint& base)
+			: loop_(loop), base_(base) {
+			base_.non_blocking(true);
+			loop_.add(base_.native_handle(), EPOLLIN | EPOLLOUT | EPOLLRDHUP, [this](const std::uint32_t events) {
+				// resuming may destroy this object
+				const auto __r = events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR) ? std::exchange(reader_, {}) : nullptr;
+				const auto __w = events & (EPOLLOUT | EPOLLHUP | EPOLLERR) ? std::exchange(writer_, {}) : nullptr;
+				if (__r)
+					__r.resume();
+				if (__w)
+					__w.resume();
+			});
+		}
+
+		async_endpoint(const async_endpoint&) = delete;
+
+		async_endpoint& operator=(const async_endpoint&) = delete;
+
+		~async_endpoint() {
+			loop_.remove(base_.native_handle());
+		}
+
+		endpoint& base() {
+			return base_;
+		}
+
+		/// Reads what is available, waiting for at least one octet; 0 once the peer has closed the connection.
+		task<std::size_t> async_read_some(const std::span<std::uint8_t> buffer) {
+			while (true) {
+				if (const auto __n = base_.try_read_some(buffer))
+					co_return __n.value();
+				co_await waiter_{reader_};
+			}
+		}
+
+		/// Sends all of `data`, waiting whenever the send buffer is full.
+		task<void> async_write(byte_string_view data) {
+			while (!data.empty()) {
+				if (const auto __n = base_.try_write(data))
+					data.remove_prefix(__n);
+				else
+					co_await waiter_{writer_};
+			}
+		}
+
+	private:
+		/// Parks the coroutine until the reactor reports the matching readiness.
+		struct waiter_ {
+
+			std::coroutine_handle<>& slot;
+
+			bool await_ready() const noexcept {
+				return false;
+			}
+
+			void await_suspend(const std::coroutine_handle<> h) const noexcept {
+				slot = h;
+			}
+
+			void await_resume() const noexcept {}
+		};
+
+		reactor& loop_;
+
+		endpoint& base_;
+
+		std::coroutine_handle<> reader_, writer_;
+	};
+
+	/// Resolves `host` through `dns` without blocking the loop; a lookup in progress resumes on the loop thread.
+	class resolution {
+	public:
+		resolution(reactor& loop, resolver& dns, const std::string_view host)
+			: loop_(loop), dns_(dns), host_(host) {
+		}
+
+		bool await_ready() {
+			if (auto __c = dns_.cached(host_)) {
+				value_ = std::move(*__c);
+				return true;
+			}
+			return false;
+		}
+
+		void await_suspend(const std::coroutine_handle<> h) {
+			dns_.resolve(host_, [this, h](resolver::result r) {
+				value_ = std::move(r);
+				loop_.post([h] {
+					h.resume();
+				});
+			});
+		}
+
+		resolver::result await_resume() {
+			return std::move(value_);
+		}
+
+	private:
+		reactor& loop_;
+
+		resolver& dns_;
+
+		std::string host_;
+
+		resolver::result value_;
+	};
+
+	/// Resolves and connects `c` without blocking the loop; `c` is left in non-blocking mode.
+	inline task<void> async_connect(reactor& loop, client& c, const std::string host, const tcp_port_t port) {
+		const auto __addresses = co_await resolution{loop, *c.dns, host};
+		if (__addresses->empty())
+			throw std::runtime_error(std::format("tcp: cannot resolve {}", host));
+		if (!c.begin_connect(*__addresses, port)) {
+			co_await readiness{loop, c.native_handle(), EPOLLOUT};
+			c.complete_connect();
+		}
+	}
+
+	/// Waits for the next connection on a listening `s`; the connection is in non-blocking mode.
+	inline task<std::unique_ptr<endpoint>> async_accept(reactor& loop, server& s) {
+		s.non_blocking(true);
+		while (true) {
+			if (auto __e = s.try_accept())
+				co_return __e;
+			co_await readiness{loop, s.native_handle(), EPOLLIN};
+		}
+	}
+
+	/// Starts `t` and runs `loop` until it finishes, then returns its result.
+	template<class T>
+	T block_on(reactor& loop, task<T> t) {
+		t.start();
+		while (!t.done())
+			loop.run_once();
+		return t.get();
+	}
+}
+
+#endif
@@ -1,31 +1,148 @@
 #pragma once
 #include "tcp/endpoint.h"
+#include "tcp/resolver.h"
 
 namespace network::tcp {
 
 	struct client final: stream_client, endpoint {
 
+		/// Applied to the socket before it connects.
+		socket_options options;
+
+		/// Resolves host names for `connect()` and `begin_connect()`.
+		resolver* dns = &resolver::global();
+
 		void connect(const std::string_view host, const tcp_port_t port) override {
+			connect(*resolve_(host), port);
+		}
+
+		[[nodiscard]] bool alive() const override {
+			return endpoint::alive();
+		}
+
+		/// Head start given to each connection attempt before the next address is tried in parallel (RFC 8305).
+		std::chrono::milliseconds attempt_delay{250};
+
+		/**
+		 * \brief Connects to whichever of `addresses` accepts first ("Happy Eyeballs", RFC 8305).
+		 *
+		 * Addresses are tried alternating between families, starting with the family of the first one. A new attempt
+		 * starts every `attempt_delay`, or as soon as the previous one fails, while earlier attempts keep running; the
+		 * first to complete is kept and the others are abandoned. An unresponsive address therefore costs
+		 * `attempt_delay` instead of a whole TCP timeout.
+		 */
+		void connect(const std::vector<resolver::address>& addresses, const tcp_port_t port) {
+			using clock = std::chrono::steady_clock;
 			close();
-			addrinfo
-					__hint{.ai_family = AF_INET, .ai_socktype = SOCK_STREAM, .ai_protocol = IPPROTO_TCP},
-					* __result = nullptr;
-			if (const std::string host_copy(host);
-					getaddrinfo(host_copy.c_str(), std::to_string(port).c_str(), &__hint, &__result))
-				handle_error_("getaddrinfo");
-			for (auto ptr = __result; ptr; ptr = ptr->ai_next) {
-				socket_ = socket(ptr->ai_family, ptr->ai_socktype, ptr->ai_protocol);
-				if (socket_ == invalid_socket)
+			const auto __order = interleave_(addresses);
+			std::vector<pollfd> __attempts;
+			const auto __abandon = [&] {
+				for (const auto& __p: __attempts)
+					::closesocket(__p.fd);
+			};
+			auto __next = __order.begin();
+			auto __next_time = clock::now();
+			while (__next != __order.end() || !__attempts.empty()) {
+				if (__next != __order.end() && (__attempts.empty() || clock::now() >= __next_time)) {
+					const auto __target = (*__next++)->with_port(port);
+					const socket_t __s = socket(__target.family(), SOCK_STREAM, IPPROTO_TCP);
+					if (__s == invalid_socket)
+						continue;
+					try {
+						options.apply(__s, socket_options::role_t::connecting);
+						set_non_blocking(__s, true);
+					} catch (...) {
+						::closesocket(__s);
+						__abandon();
+						throw;
+					}
+					if (::connect(__s, __target.get(), __target.length) == 0) {
+						__abandon();
+						return established_(__s);
+					}
+					if (last_error == error_in_progress)
+						__attempts.push_back({.fd = __s, .events = POLLOUT, .revents = 0});
+					else
+						// failed at once: the next address need not wait
+						::closesocket(__s);
+					__next_time = clock::now() + attempt_delay;
 					continue;
-				if (const int result = ::connect(socket_, ptr->ai_addr, ptr->ai_addrlen); result) {
-					close();
+				}
+				int __timeout = -1;
+				if (__next != __order.end())
+					__timeout = static_cast<int>(std::max<std::int64_t>(0, std::chrono::ceil<std::chrono::milliseconds>(
+							__next_time - clock::now()).count()));
+#ifdef PLATFORM_Windows
+				const int __n = WSAPoll(__attempts.data(), __attempts.size(), __timeout);
+#else
+				const int __n = ::poll(__attempts.data(), __attempts.size(), __timeout);
+#endif
+				if (__n < 0 && last_error != EINTR) {
+					__abandon();
+					handle_error_("poll");
+				}
+				for (auto __it = __attempts.begin(); __n > 0 && __it != __attempts.end(); )
+					if (__it->revents) {
+						int __error = 0;
+						socklen_t __size = sizeof __error;
+						getsockopt(__it->fd, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&__error), &__size);
+						if (!__error) {
+							const auto __s = __it->fd;
+							__attempts.erase(__it);
+							__abandon();
+							return established_(__s);
+						}
+						::closesocket(__it->fd);
+						__it = __attempts.erase(__it);
+						__next_time = clock::now();
+					} else
+						++__it;
+			}
+			throw std::runtime_error(std::format("tcp: no address of port {} is reachable", port));
+		}
+
+		/**
+		 * \brief Non-blocking counterpart of `connect()`: leaves the socket in non-blocking mode.
+		 * \return Whether the connection is already established; otherwise wait until the socket is writable and call
+		 * `complete_connect()`.
+		 */
+		bool begin_connect(const std::string_view host, const tcp_port_t port) {
+			return begin_connect(*resolve_(host), port);
+		}
+
+		bool begin_connect(const std::vector<resolver::address>& addresses, const tcp_port_t port) {
+			close();
+			bool __established = false;
+			for (const auto __a: interleave_(addresses)) {
+				socket_ = socket(__a->family(), SOCK_STREAM, IPPROTO_TCP);
+				if (socket_ == invalid_socket)
 					continue;
+				options.apply(socket_, socket_options::role_t::connecting);
+				set_non_blocking(socket_, true);
+				const auto __target = __a->with_port(port);
+				if (::connect(socket_, __target.get(), __target.length) == 0) {
+					__established = true;
+					break;
 				}
-				break;
+				if (last_error == error_in_progress)
+					break;
+				close();
 			}
-			freeaddrinfo(__result);
 			if (socket_ == invalid_socket)
-				throw std::runtime_error(std::format("tcp: {}:{} is unreachable", host, port));
+				throw std::runtime_error(std::format("tcp: no address of port {} is reachable", port));
+			return __established;
+		}
+
+		/// Finishes a connection started by `begin_connect()` once the socket is writable; throws if it failed.
+		void complete_connect() {
+			int __error = 0;
+			socklen_t __size = sizeof __error;
+			if (getsockopt(socket_, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&__error), &__size))
+				handle_error_("getsockopt(SO_ERROR)");
+			if (__error) {
+				close();
+				throw std::runtime_error(std::format("tcp: connect gives error {}", __error));
+			}
 		}
 
 		std::size_t available() override {
@@ -34,5 +151,35 @@ namespace network::tcp {
 				handle_error_("ioctl(FIONREAD)");
 			return avail;
 		}
+
+	private:
+		/// Orders `addresses` alternating between families, keeping the relative order within each family.
+		static std::vector<const resolver::address*> interleave_(const std::vector<resolver::address>& addresses) {
+			std::vector<const resolver::address*> __first, __other;
+			for (const auto& __a: addresses)
+				(__a.family() == addresses.front().family() ? __first : __other).push_back(&__a);
+			std::vector<const resolver::address*> __r;
+			__r.reserve(addresses.size());
+			for (std::size_t i = 0; i < std::max(__first.size(), __other.size()); ++i) {
+				if (i < __first.size())
+					__r.push_back(__first[i]);
+				if (i < __other.size())
+					__r.push_back(__other[i]);
+			}
+			return __r;
+		}
+
+		/// Adopts a connected socket, back in blocking mode.
+		void established_(const socket_t s) {
+			set_non_blocking(s, false);
+			socket_ = s;
+		}
+
+		resolver::result resolve_(const std::string_view host) const {
+			auto __r = dns->resolve(host);
+			if (__r->empty())
+				throw std::runtime_error(std::format("tcp: cannot resolve {}", host));
+			return __r;
+		}
 	};
 }
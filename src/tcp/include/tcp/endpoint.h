@@ -1,12 +1,30 @@
 #pragma once
 #include "stream_endpoint.h"
 #include <stdexcept>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <format>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
 
 #ifdef PLATFORM_Linux
 
+#include <climits>
+#include <fcntl.h>
 #include <netdb.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <linux/errqueue.h>
 #include <sys/ioctl.h>
+#include <sys/socket.h>
 #include <unistd.h>
 
 #elifdef PLATFORM_Generic
@@ -25,7 +43,10 @@
 #define error_conn_aborted WSAECONNABORTED
 #define error_conn_reset WSAECONNRESET
 #define error_conn_refused WSAECONNREFUSED
+#define error_would_block WSAEWOULDBLOCK
+#define error_in_progress WSAEWOULDBLOCK
 #define ioctl ioctlsocket
+#define SHUT_RD SD_RECEIVE
 #define SHUT_WR SD_SEND
 #define SHUT_RDWR SD_BOTH
 
@@ -37,6 +58,8 @@
 #define error_conn_aborted ECONNABORTED
 #define error_conn_reset ECONNRESET
 #define error_conn_refused ECONNREFUSED
+#define error_would_block EWOULDBLOCK
+#define error_in_progress EINPROGRESS
 #define closesocket close
 
 #endif
@@ -64,6 +87,95 @@ namespace network::tcp {
 #endif
 
 
+	/// Switches `socket` between blocking and non-blocking mode.
+	inline void set_non_blocking(const socket_t socket, const bool enable) {
+#ifdef PLATFORM_Windows
+		u_long __mode = enable;
+		if (ioctlsocket(socket, FIONBIO, &__mode))
+			throw std::runtime_error(std::format("ioctlsocket(FIONBIO) gives error {}", last_error));
+#else
+		const int __flags = fcntl(socket, F_GETFL, 0);
+		if (__flags < 0 || fcntl(socket, F_SETFL, enable ? __flags | O_NONBLOCK : __flags & ~O_NONBLOCK) < 0)
+			throw std::runtime_error(std::format("fcntl(O_NONBLOCK) gives error {}", last_error));
+#endif
+	}
+
+
+	/**
+	 * \brief Socket tuning applied when a socket is created; unset members keep the system default.
+	 *
+	 * Options the platform lacks are ignored.
+	 */
+	struct socket_options {
+
+		/// Disables Nagle's algorithm (TCP_NODELAY), so small writes such as HTTP/2 frames leave at once.
+		std::optional<bool> no_delay;
+
+		/// SO_SNDBUF and SO_RCVBUF, in octets.
+		std::optional<int> send_buffer, receive_buffer;
+
+		/// Acknowledges immediately instead of delaying ACKs (TCP_QUICKACK); the kernel may clear it again later.
+		std::optional<bool> quick_ack;
+
+		/// Microseconds to busy-poll the device queue on blocking receives (SO_BUSY_POLL).
+		std::optional<int> busy_poll;
+
+		/**
+		 * \brief TCP Fast Open: on a listening socket the length of the pending-TFO queue (TCP_FASTOPEN); on a
+		 * connecting socket any value sends data with the SYN when possible (TCP_FASTOPEN_CONNECT).
+		 */
+		std::optional<int> fast_open;
+
+		struct keepalive_t {
+
+			/// Seconds of idleness before the first probe, seconds between probes, and probes before giving up.
+			int idle, interval, count;
+		};
+
+		/// Enables SO_KEEPALIVE with the given timing.
+		std::optional<keepalive_t> keepalive;
+
+		/// What a socket is used for; selects the meaning of `fast_open`, which accepted sockets ignore.
+		enum class role_t { connecting, listening, accepted };
+
+		/// Applies the options to `socket`.
+		void apply(const socket_t socket, const role_t role = role_t::accepted) const {
+			const auto __set = [socket](const int level, const int name, const int value, const std::string_view option) {
+				if (setsockopt(socket, level, name, reinterpret_cast<const char*>(&value), sizeof value))
+					throw std::runtime_error(std::format("setsockopt({}) gives error {}", option, last_error));
+			};
+			if (no_delay)
+				__set(IPPROTO_TCP, TCP_NODELAY, *no_delay, "TCP_NODELAY");
+			if (send_buffer)
+				__set(SOL_SOCKET, SO_SNDBUF, *send_buffer, "SO_SNDBUF");
+			if (receive_buffer)
+				__set(SOL_SOCKET, SO_RCVBUF, *receive_buffer, "SO_RCVBUF");
+#ifdef TCP_QUICKACK
+			if (quick_ack)
+				__set(IPPROTO_TCP, TCP_QUICKACK, *quick_ack, "TCP_QUICKACK");
+#endif
+#ifdef SO_BUSY_POLL
+			if (busy_poll)
+				__set(SOL_SOCKET, SO_BUSY_POLL, *busy_poll, "SO_BUSY_POLL");
+#endif
+#ifdef TCP_FASTOPEN_CONNECT
+			if (fast_open && role == role_t::listening)
+				__set(IPPROTO_TCP, TCP_FASTOPEN, *fast_open, "TCP_FASTOPEN");
+			if (fast_open && role == role_t::connecting)
+				__set(IPPROTO_TCP, TCP_FASTOPEN_CONNECT, 1, "TCP_FASTOPEN_CONNECT");
+#endif
+			if (keepalive) {
+				__set(SOL_SOCKET, SO_KEEPALIVE, 1, "SO_KEEPALIVE");
+#ifdef TCP_KEEPIDLE
+				__set(IPPROTO_TCP, TCP_KEEPIDLE, keepalive->idle, "TCP_KEEPIDLE");
+				__set(IPPROTO_TCP, TCP_KEEPINTVL, keepalive->interval, "TCP_KEEPINTVL");
+				__set(IPPROTO_TCP, TCP_KEEPCNT, keepalive->count, "TCP_KEEPCNT");
+#endif
+			}
+		}
+	};
+
+
 	struct endpoint: virtual stream_endpoint {
 
 		endpoint(socket_t socket = invalid_socket)
@@ -77,6 +189,82 @@ namespace network::tcp {
 			return socket_ != invalid_socket;
 		}
 
+		/// The underlying socket, for system calls this class does not wrap.
+		[[nodiscard]] socket_t native_handle() const {
+			return socket_;
+		}
+
+		/// Switches the socket between blocking and non-blocking mode; see `try_read_some()` and `try_write()`.
+		void non_blocking(const bool enable) {
+			set_non_blocking(socket_, enable);
+		}
+
+		/// Whether the connection is still open, checked without blocking: false once the peer has closed it or reset.
+		[[nodiscard]] bool alive() const {
+			if (socket_ == invalid_socket)
+				return false;
+			pollfd __p{.fd = socket_, .events = POLLIN, .revents = 0};
+#ifdef PLATFORM_Windows
+			const int __n = WSAPoll(&__p, 1, 0);
+#else
+			const int __n = ::poll(&__p, 1, 0);
+#endif
+			if (__n <= 0)
+				return __n == 0;
+			char __c;
+			// readable and nothing to peek means end of stream
+			return recv(socket_, &__c, 1, MSG_PEEK) > 0;
+		}
+
+		/// Adjusts the options of the connected socket.
+		void set_options(const socket_options& options) {
+			options.apply(socket_);
+		}
+
+		/// Holds back partial segments while corked (TCP_CORK), so that several writes leave as full packets.
+		void cork(const bool enable) override {
+#ifdef TCP_CORK
+			if (const int __v = enable; socket_ != invalid_socket &&
+					setsockopt(socket_, IPPROTO_TCP, TCP_CORK, &__v, sizeof __v))
+				handle_error_("setsockopt(TCP_CORK)");
+#endif
+		}
+
+		/**
+		 * \brief Non-blocking counterpart of `read_some()`.
+		 * \return `std::nullopt` if no data is available yet; 0 once the peer has closed the connection.
+		 */
+		std::optional<std::size_t> try_read_some(const std::span<std::uint8_t> buffer) {
+			if (socket_ == invalid_socket)
+				return 0;
+			const auto count = recv(socket_, reinterpret_cast<char*>(buffer.data()),
+				std::min<std::size_t>(buffer.size(), std::numeric_limits<int>::max()), 0);
+			if (count < 0) {
+				if (last_error == error_would_block)
+					return std::nullopt;
+				handle_error_("recv");
+			}
+			if (count == 0 && !buffer.empty())
+				close();
+			return count;
+		}
+
+		/**
+		 * \brief Non-blocking counterpart of `write()`.
+		 * \return The number of octets sent, possibly fewer than `buffer.size()`; 0 if the send buffer is full.
+		 */
+		std::size_t try_write(const byte_string_view buffer) {
+			if (socket_ == invalid_socket)
+				throw std::runtime_error("tcp not established");
+			const auto result = send(socket_, reinterpret_cast<const char*>(buffer.data()), buffer.size(), 0);
+			if (result < 0) {
+				if (last_error == error_would_block)
+					return 0;
+				handle_error_("send");
+			}
+			return result;
+		}
+
 		std::uint8_t read() override {
 			if (socket_ == invalid_socket)
 				throw std::runtime_error("tcp not established");
@@ -94,21 +282,30 @@ namespace network::tcp {
 		byte_string read(std::size_t size) override {
 			if (socket_ == invalid_socket)
 				throw std::runtime_error("tcp not established");
-			byte_string read_data;
-			while (read_data.size() < size) {
-				std::uint8_t buffer[1024];
-				const auto count = recv(socket_, reinterpret_cast<char*>(buffer), std::min<int>(size - read_data.size(), 1024), 0);
-				if (count < 0)
-					handle_error_("recv");
-				if (count == 0) {
-					close();
+			byte_string read_data(size, 0);
+			std::size_t __read = 0;
+			while (__read < size) {
+				const auto count = read_some(std::span{read_data}.subspan(__read));
+				if (count == 0)
 					break;
-				}
-				read_data.append(buffer, count);
+				__read += count;
 			}
+			read_data.resize(__read);
 			return read_data;
 		}
 
+		std::size_t read_some(const std::span<std::uint8_t> buffer) override {
+			if (socket_ == invalid_socket)
+				return 0;
+			const auto count = recv(socket_, reinterpret_cast<char*>(buffer.data()),
+				std::min<std::size_t>(buffer.size(), std::numeric_limits<int>::max()), 0);
+			if (count < 0)
+				handle_error_("recv");
+			if (count == 0 && !buffer.empty())
+				close();
+			return count;
+		}
+
 		void write(const byte_string_view buffer) override {
 			if (socket_ == invalid_socket)
 				throw std::runtime_error("tcp not established");
@@ -123,6 +320,175 @@ namespace network::tcp {
 			write({&octet, 1});
 		}
 
+		/// Sends all `buffers` with as few system calls as possible (`sendmsg`/`WSASend`), resuming after short writes.
+		void write(const std::span<const byte_string_view> buffers) override {
+			if (socket_ == invalid_socket)
+				throw std::runtime_error("tcp not established");
+#ifdef PLATFORM_Windows
+			std::vector<WSABUF> __v;
+			for (const auto __b: buffers)
+				if (!__b.empty())
+					__v.push_back({static_cast<ULONG>(__b.size()), reinterpret_cast<CHAR*>(const_cast<std::uint8_t*>(__b.data()))});
+			DWORD __sent;
+			if (!__v.empty() && WSASend(socket_, __v.data(), __v.size(), &__sent, 0, nullptr, nullptr))
+				handle_error_("WSASend");
+#else
+#ifdef IOV_MAX
+			constexpr std::size_t max_iov = IOV_MAX;
+#else
+			constexpr std::size_t max_iov = 16;
+#endif
+			std::vector<iovec> __v;
+			__v.reserve(buffers.size());
+			for (const auto __b: buffers)
+				if (!__b.empty())
+					__v.push_back({const_cast<std::uint8_t*>(__b.data()), __b.size()});
+			for (auto __it = __v.begin(); __it != __v.end(); ) {
+				msghdr __m{};
+				__m.msg_iov = &*__it;
+				__m.msg_iovlen = std::min<std::size_t>(__v.end() - __it, max_iov);
+				const auto __result = sendmsg(socket_, &__m, 0);
+				if (__result < 0)
+					handle_error_("sendmsg");
+				if (__result == 0) {
+					close();
+					return;
+				}
+				// skip what was sent, possibly stopping inside a buffer
+				for (auto __sent = static_cast<std::size_t>(__result); __sent; )
+					if (__sent >= __it->iov_len)
+						__sent -= __it++->iov_len;
+					else {
+						__it->iov_base = static_cast<std::uint8_t*>(__it->iov_base) + __sent;
+						__it->iov_len -= __sent;
+						__sent = 0;
+					}
+			}
+#endif
+		}
+
+		/// Buffer given to `write_zerocopy()`; the endpoint holds a reference until the kernel no longer reads from it.
+		using zerocopy_buffer = std::shared_ptr<const byte_string>;
+
+		/// Buffers smaller than this are copied by `write_zerocopy()`, pinning pages being dearer than copying them.
+		std::size_t zerocopy_threshold = 1 << 14;
+
+		/// Enables zero-copy sends (SO_ZEROCOPY); returns whether the kernel supports them.
+		bool zerocopy(const bool enable) {
+#if defined(PLATFORM_Linux) && defined(SO_ZEROCOPY)
+			const int __v = enable;
+			zerocopy_ = !setsockopt(socket_, SOL_SOCKET, SO_ZEROCOPY, &__v, sizeof __v) && enable;
+			return zerocopy_ == enable;
+#else
+			return !enable;
+#endif
+		}
+
+		/**
+		 * \brief Sends `buffer` without copying it into the kernel (MSG_ZEROCOPY), if zero-copy is enabled and the
+		 * buffer reaches `zerocopy_threshold`.
+		 *
+		 * The kernel reads the memory after the call returns, so the endpoint keeps a reference to `buffer` until
+		 * `reap_zerocopy()` sees the completion; once `buffer.use_count()` drops back, the caller may reuse it.
+		 */
+		void write_zerocopy(zerocopy_buffer buffer) {
+#if defined(PLATFORM_Linux) && defined(SO_ZEROCOPY)
+			if (!zerocopy_ || buffer->size() < zerocopy_threshold)
+				return write(*buffer);
+			if (socket_ == invalid_socket)
+				throw std::runtime_error("tcp not established");
+			byte_string_view __rest{*buffer};
+			while (!__rest.empty()) {
+				const auto __n = send(socket_, __rest.data(), __rest.size(), MSG_ZEROCOPY);
+				if (__n < 0) {
+					if (errno == EINTR)
+						continue;
+					if (errno == ENOBUFS && !zerocopy_pending_.empty()) {
+						// out of option memory for pinned pages: wait for completions
+						pollfd __p{.fd = socket_, .events = 0, .revents = 0};
+						::poll(&__p, 1, -1);
+						reap_zerocopy();
+						continue;
+					}
+					handle_error_("send(MSG_ZEROCOPY)");
+				}
+				// every successful call is numbered, and completions refer to these numbers
+				zerocopy_pending_.push_back({zerocopy_sequence_++, buffer});
+				__rest.remove_prefix(__n);
+			}
+#else
+			write(*buffer);
+#endif
+		}
+
+		/**
+		 * \brief Reads zero-copy completions from the socket error queue without blocking, releasing the buffers
+		 * they cover.
+		 * \return The number of buffer references released.
+		 */
+		std::size_t reap_zerocopy() {
+			std::size_t __released = 0;
+			if (!reap_zerocopy_(__released))
+				handle_error_("recvmsg(MSG_ERRQUEUE)");
+			return __released;
+		}
+
+		/// Buffer references still held for sends the kernel has not completed.
+		[[nodiscard]] std::size_t zerocopy_pending() const {
+			return zerocopy_pending_.size();
+		}
+
+		/// Completions for which the kernel copied after all, e.g. over loopback; zero-copy then only adds overhead.
+		[[nodiscard]] std::size_t zerocopy_copied() const {
+			return zerocopy_copied_;
+		}
+
+		/// Sockets closed with zero-copy sends pending, in the whole process, held open until their completions arrive.
+		[[nodiscard]] static std::size_t zerocopy_lingering() {
+#if defined(PLATFORM_Linux) && defined(SO_ZEROCOPY)
+			return zerocopy_reaper_::global().size();
+#else
+			return 0;
+#endif
+		}
+
+		/**
+		 * \brief Sends from a file without copying through user space: `sendfile` for regular files, `splice` for pipes.
+		 *
+		 * Falls back to copying where the kernel cannot do so, e.g. for files on filesystems without `sendfile`
+		 * support. Requires a blocking socket.
+		 */
+		std::size_t send_file(const int fd, const std::uint64_t offset, const std::size_t length) override {
+#ifdef PLATFORM_Linux
+			if (socket_ == invalid_socket)
+				throw std::runtime_error("tcp not established");
+			struct stat __st;
+			if (fstat(fd, &__st))
+				handle_error_("fstat");
+			const bool __pipe = S_ISFIFO(__st.st_mode);
+			auto __offset = static_cast<off_t>(offset);
+			std::size_t __sent = 0;
+			while (__sent < length) {
+				const auto __n = __pipe
+					? splice(fd, nullptr, socket_, nullptr, length - __sent, SPLICE_F_MOVE | SPLICE_F_MORE)
+					: ::sendfile(socket_, fd, &__offset, length - __sent);
+				if (__n < 0) {
+					if (errno == EINTR)
+						continue;
+					if (!__sent && (errno == EINVAL || errno == ENOSYS))
+						return ostream::send_file(fd, offset, length);
+					handle_error_(__pipe ? "splice" : "sendfile");
+				}
+				if (__n == 0)
+					break;
+				__sent += __n;
+			}
+			return __sent;
+#else
+			return ostream::send_file(fd, offset, length);
+#endif
+		}
+
 		void finish() override {
 			if (socket_ == invalid_socket)
 				throw std::runtime_error("tcp not established");
@@ -130,16 +496,22 @@ namespace network::tcp {
 				handle_error_("shutdown(write)");
 		}
 
+		/**
+		 * \brief Shuts the connection down and closes the socket without blocking.
+		 *
+		 * With zero-copy sends still pending, the socket is handed to a background thread instead, which keeps it open
+		 * until their completions arrive and then releases the buffers and closes it.
+		 */
 		void close() override {
 			if (socket_ != invalid_socket) {
 				shutdown(socket_, SHUT_RDWR);
-				::closesocket(socket_);
-				socket_ = invalid_socket;
+				release_socket_();
 			}
+			zerocopy_ = false;
 		}
 
 		~endpoint() override {
-			::closesocket(socket_);
+			release_socket_();
 #ifdef PLATFORM_Windows
 			wsa_control::release();
 #endif
@@ -148,6 +520,164 @@ namespace network::tcp {
 	protected:
 		socket_t socket_;
 
+		bool zerocopy_ = false;
+
+		std::uint32_t zerocopy_sequence_ = 0;
+
+		std::size_t zerocopy_copied_ = 0;
+
+		/// Call number of each zero-copy send with the buffer it reads from.
+		std::deque<std::pair<std::uint32_t, zerocopy_buffer>> zerocopy_pending_;
+
+		/// Does the work of `reap_zerocopy()`, adding to `released`; false on an error, which is left in `errno`.
+		bool reap_zerocopy_(std::size_t& released) {
+			return reap_zerocopy_(socket_, zerocopy_pending_, zerocopy_copied_, released);
+		}
+
+		/// Releases the buffers of `pending` whose sends on `socket` have completed, counting copies in `copied`.
+		static bool reap_zerocopy_(const socket_t socket, std::deque<std::pair<std::uint32_t, zerocopy_buffer>>& pending,
+				std::size_t& copied, std::size_t& released) {
+#if defined(PLATFORM_Linux) && defined(SO_ZEROCOPY)
+			while (!pending.empty()) {
+				char __control[128];
+				msghdr __m{};
+				__m.msg_control = __control;
+				__m.msg_controllen = sizeof __control;
+				if (recvmsg(socket, &__m, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+					if (errno == EINTR)
+						continue;
+					if (errno == EAGAIN || errno == EWOULDBLOCK)
+						break;
+					return false;
+				}
+				for (auto __c = CMSG_FIRSTHDR(&__m); __c; __c = CMSG_NXTHDR(&__m, __c)) {
+					if (!(__c->cmsg_level == SOL_IP && __c->cmsg_type == IP_RECVERR)
+							&& !(__c->cmsg_level == SOL_IPV6 && __c->cmsg_type == IPV6_RECVERR))
+						continue;
+					const auto __e = reinterpret_cast<const sock_extended_err*>(CMSG_DATA(__c));
+					if (__e->ee_origin != SO_EE_ORIGIN_ZEROCOPY)
+						continue;
+					if (__e->ee_code & SO_EE_CODE_ZEROCOPY_COPIED)
+						++copied;
+					// the range [ee_info, ee_data] of call numbers has completed, possibly wrapping around
+					while (!pending.empty() && pending.front().first - __e->ee_info <= __e->ee_data - __e->ee_info) {
+						pending.pop_front();
+						++released;
+					}
+				}
+			}
+#endif
+			return true;
+		}
+
+#if defined(PLATFORM_Linux) && defined(SO_ZEROCOPY)
+		/**
+		 * \brief Holds sockets closed with zero-copy sends pending, one thread for the whole process.
+		 *
+		 * The kernel reads the buffers until it reports completion, which needs the socket open. Completions arrive
+		 * once the data is acknowledged, or dropped when the connection is reset or times out, so every socket is
+		 * closed eventually; the thread starts with the first one.
+		 */
+		class zerocopy_reaper_ {
+		public:
+			static zerocopy_reaper_& global() {
+				static zerocopy_reaper_ __r;
+				return __r;
+			}
+
+			~zerocopy_reaper_() {
+				{
+					std::lock_guard __l{mutex_};
+					stopping_ = true;
+				}
+				added_.notify_one();
+				if (thread_.joinable())
+					thread_.join();
+				for (const auto& __s: sockets_)
+					::closesocket(__s.socket);
+			}
+
+			void adopt(const socket_t socket, std::deque<std::pair<std::uint32_t, zerocopy_buffer>> pending) {
+				{
+					std::lock_guard __l{mutex_};
+					sockets_.push_back({socket, std::move(pending)});
+					if (!thread_.joinable())
+						thread_ = std::thread{[this] {
+							run_();
+						}};
+				}
+				added_.notify_one();
+			}
+
+			[[nodiscard]] std::size_t size() const {
+				std::lock_guard __l{mutex_};
+				return sockets_.size();
+			}
+
+		private:
+			struct socket_ {
+
+				socket_t socket;
+
+				std::deque<std::pair<std::uint32_t, zerocopy_buffer>> pending;
+			};
+
+			mutable std::mutex mutex_;
+
+			std::condition_variable added_;
+
+			std::vector<socket_> sockets_;
+
+			std::thread thread_;
+
+			bool stopping_ = false;
+
+			void run_() {
+				std::unique_lock __l{mutex_};
+				while (!stopping_) {
+					if (sockets_.empty()) {
+						added_.wait(__l, [this] { return stopping_ || !sockets_.empty(); });
+						continue;
+					}
+					std::vector<pollfd> __p;
+					for (const auto& __s: sockets_)
+						__p.push_back({.fd = __s.socket, .events = 0, .revents = 0});
+					__l.unlock();
+					// POLLERR signals a queued completion; a hung-up socket returns at once, so back off instead
+					if (::poll(__p.data(), __p.size(), 100) > 0
+							&& std::ranges::none_of(__p, [](const pollfd& p) { return p.revents & POLLERR; }))
+						std::this_thread::sleep_for(std::chrono::milliseconds(10));
+					__l.lock();
+					std::erase_if(sockets_, [](socket_& s) {
+						std::size_t __copied = 0, __released = 0;
+						if (reap_zerocopy_(s.socket, s.pending, __copied, __released) && !s.pending.empty())
+							return false;
+						::closesocket(s.socket);
+						return true;
+					});
+				}
+			}
+		};
+#endif
+
+		/// Closes the socket, or hands it to the reaper while zero-copy sends are pending.
+		void release_socket_() {
+			if (socket_ == invalid_socket)
+				return;
+#if defined(PLATFORM_Linux) && defined(SO_ZEROCOPY)
+			std::size_t __released = 0;
+			if (reap_zerocopy_(__released) && !zerocopy_pending_.empty()) {
+				zerocopy_reaper_::global().adopt(socket_, std::move(zerocopy_pending_));
+				zerocopy_pending_.clear();
+				socket_ = invalid_socket;
+				return;
+			}
+			zerocopy_pending_.clear();
+#endif
+			::closesocket(socket_);
+			socket_ = invalid_socket;
+		}
+
 		[[noreturn]] void handle_error_(std::string_view function) {
 			switch (const int error_no = last_error) {
 				case error_conn_aborted:
@@ -0,0 +1,158 @@
+#pragma once
+#include "tcp/endpoint.h"
+
+#ifdef PLATFORM_Linux
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+namespace network::tcp {
+
+	/**
+	 * \brief Event loop dispatching socket readiness, on edge-triggered epoll.
+	 *
+	 * Handlers are only told about transitions, so they must read, write or accept until the operation would block
+	 * (`try_read_some()`, `try_write()`, `server::try_accept()`). Registration and dispatch happen on the thread
+	 * running the loop; other threads hand work to it through `post()`, which wakes it up with an eventfd.
+	 */
+	class reactor final {
+	public:
+		/// Called with the epoll event mask, e.g. `EPOLLIN | EPOLLOUT | EPOLLHUP`.
+		using handler = std::function<void(std::uint32_t events)>;
+
+		reactor()
+			: epoll_(epoll_create1(EPOLL_CLOEXEC)), wakeup_(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) {
+			if (epoll_ < 0 || wakeup_ < 0)
+				throw std::runtime_error(std::format("reactor: epoll_create1 or eventfd gives error {}", errno));
+			epoll_event __e{.events = EPOLLIN | EPOLLET, .data = {.fd = wakeup_}};
+			if (epoll_ctl(epoll_, EPOLL_CTL_ADD, wakeup_, &__e))
+				throw std::runtime_error(std::format("reactor: epoll_ctl gives error {}", errno));
+		}
+
+		reactor(const reactor&) = delete;
+
+		reactor& operator=(const reactor&) = delete;
+
+		~reactor() {
+			::close(wakeup_);
+			::close(epoll_);
+		}
+
+		/// Starts watching `socket` for `events` (`EPOLLIN`, `EPOLLOUT`, ...); edge triggering is always on.
+		void add(const socket_t socket, const std::uint32_t events, handler h) {
+			epoll_event __e{.events = events | EPOLLET, .data = {.fd = socket}};
+			if (epoll_ctl(epoll_, EPOLL_CTL_ADD, socket, &__e))
+				throw std::runtime_error(std::format("reactor: epoll_ctl(add) gives error {}", errno));
+			handlers_[socket] = std::make_shared<handler>(std::move(h));
+		}
+
+		/// Changes the events watched on `socket`.
+		void modify(const socket_t socket, const std::uint32_t events) {
+			epoll_event __e{.events = events | EPOLLET, .data = {.fd = socket}};
+			if (epoll_ctl(epoll_, EPOLL_CTL_MOD, socket, &__e))
+				throw std::runtime_error(std::format("reactor: epoll_ctl(modify) gives error {}", errno));
+		}
+
+		/// Stops watching `socket`; must be called before it is closed. Pending events for it are dropped.
+		void remove(const socket_t socket) {
+			epoll_ctl(epoll_, EPOLL_CTL_DEL, socket, nullptr);
+			handlers_.erase(socket);
+		}
+
+		[[nodiscard]] std::size_t size() const {
+			return handlers_.size();
+		}
+
+		/// Runs `task` on the loop thread; may be called from any thread.
+		void post(std::function<void()> task) {
+			{
+				std::lock_guard __l{mutex_};
+				posted_.push_back(std::move(task));
+			}
+			wake_();
+		}
+
+		/**
+		 * \brief Waits up to `timeout` milliseconds (-1 for no limit) and dispatches what is ready.
+		 * \return The number of socket events and posted tasks handled.
+		 */
+		std::size_t run_once(const int timeout = -1) {
+			epoll_event __events[64];
+			const int __n = epoll_wait(epoll_, __events, std::size(__events), timeout);
+			if (__n < 0) {
+				if (errno == EINTR)
+					return 0;
+				throw std::runtime_error(std::format("reactor: epoll_wait gives error {}", errno));
+			}
+			std::size_t __handled = 0;
+			for (int i = 0; i < __n; ++i) {
+				if (__events[i].data.fd == wakeup_) {
+					// reading resets the counter
+					std::uint64_t __count;
+					[[maybe_unused]] const auto __r = ::read(wakeup_, &__count, sizeof __count);
+					__handled += run_posted_();
+					continue;
+				}
+				// a handler may remove itself or others while it runs
+				const auto __it = handlers_.find(__events[i].data.fd);
+				if (__it == handlers_.end())
+					continue;
+				const auto __h = __it->second;
+				(*__h)(__events[i].events);
+				++__handled;
+			}
+			return __handled;
+		}
+
+		/// Dispatches events until `stop()` is called.
+		void run() {
+			stopped_ = false;
+			while (!stopped_)
+				run_once();
+		}
+
+		/// Makes `run()` return after the tasks posted so far; may be called from any thread.
+		void stop() {
+			post([this] {
+				stopped_ = true;
+			});
+		}
+
+	private:
+		int epoll_;
+
+		int wakeup_;
+
+		std::unordered_map<socket_t, std::shared_ptr<handler>> handlers_;
+
+		std::mutex mutex_;
+
+		std::vector<std::function<void()>> posted_;
+
+		bool stopped_ = false;
+
+		void wake_() {
+			constexpr std::uint64_t __one = 1;
+			if (::write(wakeup_, &__one, sizeof __one) < 0 && errno != EAGAIN)
+				throw std::runtime_error(std::format("reactor: eventfd write gives error {}", errno));
+		}
+
+		std::size_t run_posted_() {
+			std::vector<std::function<void()>> __tasks;
+			{
+				std::lock_guard __l{mutex_};
+				std::swap(__tasks, posted_);
+			}
+			for (auto& __t: __tasks)
+				__t();
+			return __tasks.size();
+		}
+	};
+}
+
+#endif
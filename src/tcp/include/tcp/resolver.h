@@ -0,0 +1,290 @@
+#pragma once
+#include "tcp/endpoint.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#ifdef PLATFORM_Linux
+#include <netinet/in.h>
+#endif
+
+namespace network::tcp {
+
+	/**
+	 * \brief Name resolution with an in-process cache.
+	 *
+	 * Successful lookups are kept for `positive_ttl`, failed ones (including names that do not exist) for
+	 * `negative_ttl`; `getaddrinfo` does not report record TTLs, so both are fixed. At most `capacity` results are
+	 * kept: expired ones are dropped to make room, then the one expiring first. Concurrent requests for a name share
+	 * one lookup, which runs on one of a few lookup threads so that `resolve(host, callback)` never blocks its caller.
+	 * The threads are started on demand, so a resolver that only serves cached names, or none, has none.
+	 */
+	class resolver final {
+	public:
+		using clock = std::chrono::steady_clock;
+
+		struct address {
+
+			sockaddr_storage storage{};
+
+			socklen_t length = 0;
+
+			[[nodiscard]] int family() const {
+				return storage.ss_family;
+			}
+
+			[[nodiscard]] const sockaddr* get() const {
+				return reinterpret_cast<const sockaddr*>(&storage);
+			}
+
+			/// A copy of this address with the given port.
+			[[nodiscard]] address with_port(const tcp_port_t port) const {
+				auto __a = *this;
+				if (family() == AF_INET)
+					reinterpret_cast<sockaddr_in&>(__a.storage).sin_port = htons(port);
+				else if (family() == AF_INET6)
+					reinterpret_cast<sockaddr_in6&>(__a.storage).sin6_port = htons(port);
+				return __a;
+			}
+		};
+
+		/// Addresses in the order given by the system; empty if the name could not be resolved.
+		using result = std::shared_ptr<const std::vector<address>>;
+
+		/**
+		 * \param family `AF_INET`, `AF_INET6` or `AF_UNSPEC` for both.
+		 * \param workers Most threads running lookups at once; further lookups queue until one is free.
+		 */
+		explicit resolver(const int family = AF_UNSPEC,
+				const clock::duration positive_ttl = std::chrono::seconds(60),
+				const clock::duration negative_ttl = std::chrono::seconds(5),
+				const std::size_t capacity = 1024, const std::size_t workers = 4)
+			: family_(family), positive_ttl_(positive_ttl), negative_ttl_(negative_ttl), capacity_(capacity),
+			max_workers_(std::max<std::size_t>(workers, 1)) {
+		}
+
+		resolver(const resolver&) = delete;
+
+		resolver& operator=(const resolver&) = delete;
+
+		/// Completes the lookups already queued, then joins the lookup threads.
+		~resolver() {
+			{
+				std::lock_guard __l{queue_mutex_};
+				stopping_ = true;
+			}
+			queued_.notify_all();
+			for (auto& __t: workers_)
+				__t.join();
+		}
+
+		/// Resolver shared by clients that are not given one.
+		static resolver& global() {
+			static resolver __r;
+			return __r;
+		}
+
+		/// The cached result for `host`, if there is an unexpired one; never starts a lookup.
+		std::optional<result> cached(const std::string_view host) {
+			std::lock_guard __l{mutex_};
+			const auto __it = cache_.find(std::string(host));
+			if (__it == cache_.end() || !__it->second->value)
+				return std::nullopt;
+			if (clock::now() < __it->second->expiry)
+				return __it->second->value;
+			cache_.erase(__it);
+			return std::nullopt;
+		}
+
+		/// Resolves `host`, blocking until a cached, shared or new lookup completes.
+		result resolve(const std::string_view host) {
+			const auto __e = lookup_(host, nullptr);
+			return __e->done.get();
+		}
+
+		/**
+		 * \brief Resolves `host` without blocking.
+		 *
+		 * `callback` runs immediately on a cache hit, otherwise on the lookup thread once the result is known; event
+		 * loops should `post()` from it.
+		 */
+		void resolve(const std::string_view host, std::function<void(result)> callback) {
+			lookup_(host, std::move(callback));
+		}
+
+		/// Drops every cached result; lookups in flight still complete.
+		void clear() {
+			std::lock_guard __l{mutex_};
+			cache_.clear();
+		}
+
+		/// Names cached or being looked up.
+		[[nodiscard]] std::size_t size() const {
+			std::lock_guard __l{mutex_};
+			return cache_.size();
+		}
+
+		/// Lookup threads started so far.
+		[[nodiscard]] std::size_t threads() const {
+			std::lock_guard __l{queue_mutex_};
+			return workers_.size();
+		}
+
+		/// Number of lookups started, i.e. requests that were neither cached nor coalesced.
+		[[nodiscard]] std::size_t lookups() const {
+			return lookups_;
+		}
+
+	private:
+		struct entry_ {
+
+			/// Set once the lookup has finished.
+			result value;
+
+			clock::time_point expiry;
+
+			std::vector<std::function<void(result)>> waiters;
+
+			std::promise<result> promise;
+
+			std::shared_future<result> done = promise.get_future().share();
+		};
+
+		int family_;
+
+		clock::duration positive_ttl_, negative_ttl_;
+
+		std::size_t capacity_;
+
+		mutable std::mutex mutex_;
+
+		std::unordered_map<std::string, std::shared_ptr<entry_>> cache_;
+
+		std::atomic<std::size_t> lookups_ = 0;
+
+		std::size_t max_workers_;
+
+		mutable std::mutex queue_mutex_;
+
+		std::condition_variable queued_;
+
+		std::deque<std::function<void()>> queue_;
+
+		std::vector<std::thread> workers_;
+
+		/// Lookup threads waiting for work.
+		std::size_t idle_ = 0;
+
+		bool stopping_ = false;
+
+		/// Queues a lookup, starting a thread for it if none is idle and fewer than `max_workers_` run.
+		void submit_(std::function<void()> f) {
+			std::lock_guard __l{queue_mutex_};
+			queue_.push_back(std::move(f));
+			if (idle_ || workers_.size() == max_workers_) {
+				queued_.notify_one();
+				return;
+			}
+			workers_.emplace_back([this] {
+				std::unique_lock __l{queue_mutex_};
+				while (true) {
+					++idle_;
+					queued_.wait(__l, [this] { return stopping_ || !queue_.empty(); });
+					--idle_;
+					if (queue_.empty())
+						return;
+					const auto __f = std::move(queue_.front());
+					queue_.pop_front();
+					__l.unlock();
+					__f();
+					__l.lock();
+				}
+			});
+		}
+
+		/// Makes room for one more entry; lookups in flight are never dropped, so they may exceed `capacity_` a while.
+		void evict_() {
+			if (cache_.size() < capacity_)
+				return;
+			const auto __now = clock::now();
+			std::erase_if(cache_, [__now](const auto& __p) {
+				return __p.second->value && __p.second->expiry <= __now;
+			});
+			if (cache_.size() < capacity_)
+				return;
+			auto __first = cache_.end();
+			for (auto __it = cache_.begin(); __it != cache_.end(); ++__it)
+				if (__it->second->value && (__first == cache_.end() || __it->second->expiry < __first->second->expiry))
+					__first = __it;
+			if (__first != cache_.end())
+				cache_.erase(__first);
+		}
+
+		std::shared_ptr<entry_> lookup_(const std::string_view host, std::function<void(result)> callback) {
+			std::unique_lock __l{mutex_};
+			auto __it = cache_.find(std::string(host));
+			if (__it == cache_.end()) {
+				evict_();
+				__it = cache_.emplace(std::string(host), nullptr).first;
+			}
+			auto& __e = __it->second;
+			if (__e && (!__e->value || clock::now() < __e->expiry)) {
+				if (!__e->value) {
+					// coalesce with the lookup in flight
+					if (callback)
+						__e->waiters.push_back(std::move(callback));
+					return __e;
+				}
+				const auto __r = __e;
+				__l.unlock();
+				if (callback)
+					callback(__r->value);
+				return __r;
+			}
+			__e = std::make_shared<entry_>();
+			if (callback)
+				__e->waiters.push_back(std::move(callback));
+			++lookups_;
+			submit_([this, __e, __name = std::string(host)] {
+				const result __r = std::make_shared<const std::vector<address>>(query_(__name));
+				std::vector<std::function<void(result)>> __waiters;
+				{
+					std::lock_guard __l{mutex_};
+					__e->value = __r;
+					__e->expiry = clock::now() + (__r->empty() ? negative_ttl_ : positive_ttl_);
+					std::swap(__waiters, __e->waiters);
+				}
+				__e->promise.set_value(__r);
+				for (const auto& __w: __waiters)
+					__w(__r);
+			});
+			return __e;
+		}
+
+		[[nodiscard]] std::vector<address> query_(const std::string& host) const {
+			addrinfo __hint{}, * __result = nullptr;
+			__hint.ai_family = family_;
+			__hint.ai_socktype = SOCK_STREAM;
+			__hint.ai_protocol = IPPROTO_TCP;
+			std::vector<address> __a;
+			if (getaddrinfo(host.c_str(), nullptr, &__hint, &__result))
+				return __a;
+			for (auto ptr = __result; ptr; ptr = ptr->ai_next) {
+				auto& __x = __a.emplace_back();
+				std::memcpy(&__x.storage, ptr->ai_addr, ptr->ai_addrlen);
+				__x.length = ptr->ai_addrlen;
+			}
+			freeaddrinfo(__result);
+			return __a;
+		}
+	};
+}
@@ -21,6 +21,15 @@ namespace network::tcp {
 		}
 
 	public:
+		/// Lets several listening sockets share one port, the kernel spreading connections among them (SO_REUSEPORT).
+		bool reuse_port = false;
+
+		/// Applied to the listening socket and to every accepted connection.
+		socket_options options;
+
+		/// `AF_INET`, or `AF_INET6` to accept both IPv6 and IPv4 (as mapped addresses) connections.
+		int family = AF_INET;
+
 		server() {
 #ifdef PLATFORM_Windows
 			wsa_control::acquire();
@@ -29,7 +38,7 @@ namespace network::tcp {
 
 		void listen(std::uint16_t port, std::size_t max_connection) override {
 			addrinfo hint{
-					.ai_flags = AI_PASSIVE, .ai_family = AF_INET, .ai_socktype = SOCK_STREAM, .ai_protocol = IPPROTO_TCP},
+					.ai_flags = AI_PASSIVE, .ai_family = family, .ai_socktype = SOCK_STREAM, .ai_protocol = IPPROTO_TCP},
 					* result_addr = nullptr;
 			if (getaddrinfo(nullptr, std::to_string(port).c_str(), &hint, &result_addr))
 				handle_error_(std::format("getaddrinfo(null, {})", port));
@@ -37,6 +46,18 @@ namespace network::tcp {
 				socket_ = socket(ptr->ai_family, ptr->ai_socktype, ptr->ai_protocol);
 				if (socket_ == invalid_socket)
 					continue;
+				if (const int __off = 0; family == AF_INET6 &&
+						setsockopt(socket_, IPPROTO_IPV6, IPV6_V6ONLY, reinterpret_cast<const char*>(&__off), sizeof __off)) {
+					close();
+					continue;
+				}
+#ifdef SO_REUSEPORT
+				if (const int __on = 1; reuse_port &&
+						setsockopt(socket_, SOL_SOCKET, SO_REUSEPORT, reinterpret_cast<const char*>(&__on), sizeof __on)) {
+					close();
+					continue;
+				}
+#endif
 				if (const int result = ::bind(socket_, ptr->ai_addr, ptr->ai_addrlen); result) {
 					close();
 					continue;
@@ -46,6 +67,7 @@ namespace network::tcp {
 			freeaddrinfo(result_addr);
 			if (socket_ == invalid_socket)
 				handle_error_("socket() or bind()");
+			options.apply(socket_, socket_options::role_t::listening);
 			if (::listen(socket_, static_cast<int>(max_connection)))
 				handle_error_("listen()");
 		}
@@ -54,10 +76,58 @@ namespace network::tcp {
 			const socket_t socket = ::accept(socket_, nullptr, nullptr);
 			if (socket == invalid_socket)
 				handle_error_("accept()");
-			return std::make_unique<tcp::endpoint>(socket);
+			auto __e = std::make_unique<tcp::endpoint>(socket);
+			__e->set_options(options);
+			return __e;
+		}
+
+		/// The listening socket, e.g. for registering with a `reactor`.
+		[[nodiscard]] socket_t native_handle() const {
+			return socket_;
+		}
+
+		/// The port listened on, e.g. the one the system chose when `listen()` was given 0.
+		[[nodiscard]] tcp_port_t local_port() const {
+			sockaddr_storage __address{};
+			socklen_t __length = sizeof __address;
+			if (getsockname(socket_, reinterpret_cast<sockaddr*>(&__address), &__length))
+				throw std::runtime_error{std::format("getsockname() gives error {}", last_error)};
+			return ntohs(__address.ss_family == AF_INET6
+					? reinterpret_cast<const sockaddr_in6&>(__address).sin6_port
+					: reinterpret_cast<const sockaddr_in&>(__address).sin_port);
+		}
+
+		/// Switches the listening socket between blocking and non-blocking mode; see `try_accept()`.
+		void non_blocking(const bool enable) {
+			set_non_blocking(socket_, enable);
+		}
+
+		/**
+		 * \brief Non-blocking counterpart of `accept()`, for a listening socket in non-blocking mode.
+		 * \return The connection, itself in non-blocking mode, or null if none is pending.
+		 */
+		std::unique_ptr<tcp::endpoint> try_accept() {
+#ifdef PLATFORM_Linux
+			const socket_t socket = ::accept4(socket_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+#else
+			const socket_t socket = ::accept(socket_, nullptr, nullptr);
+#endif
+			if (socket == invalid_socket) {
+				if (last_error == error_would_block)
+					return nullptr;
+				handle_error_("accept()");
+			}
+			auto __e = std::make_unique<tcp::endpoint>(socket);
+			__e->set_options(options);
+#ifndef PLATFORM_Linux
+			__e->non_blocking(true);
+#endif
+			return __e;
 		}
 
 		void close() override {
+			// wakes a thread blocked in accept()
+			::shutdown(socket_, SHUT_RDWR);
 			::closesocket(socket_);
 			socket_ = invalid_socket;
 		}
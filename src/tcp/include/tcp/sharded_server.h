@@ -0,0 +1,115 @@
+#pragma once
+#include "tcp/server.h"
+#include "tcp/reactor.h"
+
+#ifdef PLATFORM_Linux
+
+#include <pthread.h>
+#include <sched.h>
+#include <thread>
+
+namespace network::tcp {
+
+	/**
+	 * \brief Listener spread over worker threads, each accepting on its own SO_REUSEPORT socket.
+	 *
+	 * Every worker owns a listening socket on the same port and a `reactor`, and runs pinned to one core; the kernel
+	 * balances incoming connections across the sockets, so no thread is a shared accept point. Connections are handed
+	 * to the callback on the worker that accepted them, which keeps serving them from its own loop.
+	 */
+	class sharded_server final {
+	public:
+		/// Called on a worker thread with a non-blocking connection and that worker's loop.
+		using connection_handler = std::function<void(std::unique_ptr<endpoint>, reactor&)>;
+
+		/// \param workers Number of shards; defaults to one per hardware thread.
+		explicit sharded_server(const std::size_t workers = std::max(1u, std::thread::hardware_concurrency()))
+			: shards_(workers) {
+		}
+
+		sharded_server(const sharded_server&) = delete;
+
+		sharded_server& operator=(const sharded_server&) = delete;
+
+		~sharded_server() {
+			stop();
+		}
+
+		/**
+		 * \brief Binds every shard to `port` and starts the workers; bind errors are thrown on the calling thread.
+		 *
+		 * With port 0 the first shard gets a port from the system and the others join it; see `local_port()`.
+		 */
+		void listen(const std::uint16_t port, const std::size_t max_connection, connection_handler on_connection) {
+			on_connection_ = std::move(on_connection);
+			for (auto& __s: shards_) {
+				__s.listener.reuse_port = true;
+				__s.listener.listen(&__s == &shards_.front() ? port : local_port(), max_connection);
+				__s.listener.non_blocking(true);
+			}
+			const auto __cores = std::max(1u, std::thread::hardware_concurrency());
+			for (std::size_t i = 0; i < shards_.size(); ++i)
+				shards_[i].worker = std::thread{[this, i, __cores] {
+					pin_(i % __cores);
+					run_(shards_[i]);
+				}};
+		}
+
+		/// The port all shards listen on.
+		[[nodiscard]] tcp_port_t local_port() const {
+			return shards_.front().listener.local_port();
+		}
+
+		[[nodiscard]] std::size_t size() const {
+			return shards_.size();
+		}
+
+		/// Loop of shard `index`, e.g. to `post()` work to it.
+		reactor& loop(const std::size_t index) {
+			return shards_[index].loop;
+		}
+
+		/// Stops every worker and waits for it to exit.
+		void stop() {
+			for (auto& __s: shards_)
+				if (__s.worker.joinable())
+					__s.loop.stop();
+			for (auto& __s: shards_)
+				if (__s.worker.joinable())
+					__s.worker.join();
+		}
+
+	private:
+		struct shard {
+
+			server listener;
+
+			reactor loop;
+
+			std::thread worker;
+		};
+
+		std::vector<shard> shards_;
+
+		connection_handler on_connection_;
+
+		static void pin_(const std::size_t core) {
+			cpu_set_t __set;
+			CPU_ZERO(&__set);
+			CPU_SET(core, &__set);
+			// best effort: the shard still works unpinned, e.g. in a restricted cpuset
+			pthread_setaffinity_np(pthread_self(), sizeof __set, &__set);
+		}
+
+		void run_(shard& s) {
+			s.loop.add(s.listener.native_handle(), EPOLLIN, [this, &s](std::uint32_t) {
+				while (auto __e = s.listener.try_accept())
+					on_connection_(std::move(__e), s.loop);
+			});
+			s.loop.run();
+			s.loop.remove(s.listener.native_handle());
+		}
+	};
+}
+
+#endif
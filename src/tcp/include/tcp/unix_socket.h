@@ -0,0 +1,184 @@
+#pragma once
+#include "tcp/endpoint.h"
+#include <cstddef>
+#include <filesystem>
+#include <string>
+
+#ifdef PLATFORM_Windows
+#include <afunix.h>
+#else
+#include <sys/un.h>
+#endif
+
+/**
+ * Unix domain stream sockets behind the `stream_client` and `stream_server` interfaces, for traffic between processes
+ * on one host. A path starting with '@' names a socket in the abstract namespace (Linux), which has no file and
+ * disappears with its last socket.
+ */
+namespace network::unix_socket {
+
+	/// Builds the address of `path`; returns its length.
+	inline socklen_t make_address(const std::string_view path, sockaddr_un& address) {
+		address = {};
+		address.sun_family = AF_UNIX;
+		if (path.empty() || path.size() >= sizeof address.sun_path)
+			throw std::runtime_error(std::format("unix socket: invalid path '{}'", path));
+		path.copy(address.sun_path, path.size());
+		// an abstract name is not terminated, and its length counts
+		if (path.front() == '@') {
+			address.sun_path[0] = '\0';
+			return static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + path.size());
+		}
+		return static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + path.size() + 1);
+	}
+
+	/// Connected unix socket; reads and writes as `tcp::endpoint` does.
+	struct endpoint: tcp::endpoint {
+
+		using tcp::endpoint::endpoint;
+
+		/// Unix sockets have no segments to coalesce.
+		void cork(bool) override {}
+	};
+
+	struct client final: stream_client, endpoint {
+
+		/**
+		 * \param path Socket to connect to whatever host is given to `connect()`, so that a client made for URLs,
+		 * such as `http::client`, reaches a local server; empty to take the host as the path.
+		 */
+		explicit client(std::string path = {})
+			: path_(std::move(path)) {
+		}
+
+		/// Connects to the socket of the constructor, or the one at `host`; `port` is ignored.
+		void connect(const std::string_view host, tcp_port_t) override {
+			close();
+			sockaddr_un __address;
+			const auto __length = make_address(path_.empty() ? host : path_, __address);
+			socket_ = socket(AF_UNIX, SOCK_STREAM, 0);
+			if (socket_ == invalid_socket)
+				handle_error_("socket(AF_UNIX)");
+			if (::connect(socket_, reinterpret_cast<const sockaddr*>(&__address), __length)) {
+				const int __error = last_error;
+				close();
+				throw std::runtime_error(std::format("unix socket: connect gives error {}", __error));
+			}
+		}
+
+		[[nodiscard]] bool alive() const override {
+			return endpoint::alive();
+		}
+
+		std::size_t available() override {
+			unsigned long avail = 0;
+			if (const auto result = ioctl(socket_, FIONREAD, &avail); result < 0)
+				handle_error_("ioctl(FIONREAD)");
+			return avail;
+		}
+
+	private:
+		std::string path_;
+	};
+
+	class server final: public stream_server {
+
+		socket_t socket_{invalid_socket};
+
+		std::string path_;
+
+		[[noreturn]] static void handle_error_(const std::string_view function) {
+			throw std::runtime_error{std::format("{} gives error {}", function, last_error)};
+		}
+
+		/// Whether the socket file at `address` was left behind: it is a socket, and nothing accepts connections on it.
+		[[nodiscard]] bool stale_(const sockaddr_un& address, const socklen_t length) const {
+			std::error_code __ec;
+			if (path_.front() == '@' || !std::filesystem::is_socket(path_, __ec))
+				return false;
+			const socket_t __probe = socket(AF_UNIX, SOCK_STREAM, 0);
+			if (__probe == invalid_socket)
+				return false;
+			// non-blocking, so a live server with a full backlog counts as live instead of stalling the probe
+			tcp::set_non_blocking(__probe, true);
+			const bool __refused = ::connect(__probe, reinterpret_cast<const sockaddr*>(&address), length)
+				&& last_error == error_conn_refused;
+			::closesocket(__probe);
+			return __refused;
+		}
+
+	public:
+		/**
+		 * \param path Where `listen()` binds. A socket file there that refuses connections, left behind by a server
+		 * that crashed, is replaced; a live server's socket or any other file makes `listen()` fail with EADDRINUSE.
+		 */
+		explicit server(std::string path)
+			: path_(std::move(path)) {
+#ifdef PLATFORM_Windows
+			tcp::wsa_control::acquire();
+#endif
+		}
+
+		server(const server&) = delete;
+
+		server& operator=(const server&) = delete;
+
+		/// Listens on the path of the constructor; the port is ignored.
+		void listen(tcp_port_t, const std::size_t max_connection) override {
+			sockaddr_un __address;
+			const auto __length = make_address(path_, __address);
+			socket_ = socket(AF_UNIX, SOCK_STREAM, 0);
+			if (socket_ == invalid_socket)
+				handle_error_("socket(AF_UNIX)");
+			if (stale_(__address, __length)) {
+				std::error_code __ec;
+				std::filesystem::remove(path_, __ec);
+			}
+			if (::bind(socket_, reinterpret_cast<const sockaddr*>(&__address), __length)) {
+				const int __error = last_error;
+				// not close(): the file there is not ours to remove
+				::closesocket(socket_);
+				socket_ = invalid_socket;
+				throw std::runtime_error{std::format("bind({}) gives error {}", path_, __error)};
+			}
+			if (::listen(socket_, static_cast<int>(max_connection)))
+				handle_error_("listen()");
+		}
+
+		std::unique_ptr<stream_endpoint> accept() override {
+			const socket_t socket = ::accept(socket_, nullptr, nullptr);
+			if (socket == invalid_socket)
+				handle_error_("accept()");
+			return std::make_unique<endpoint>(socket);
+		}
+
+		/// The listening socket, e.g. for registering with a `reactor`.
+		[[nodiscard]] socket_t native_handle() const {
+			return socket_;
+		}
+
+		[[nodiscard]] const std::string& path() const {
+			return path_;
+		}
+
+		/// Stops listening and removes the socket file.
+		void close() override {
+			if (socket_ == invalid_socket)
+				return;
+			::shutdown(socket_, SHUT_RDWR);
+			::closesocket(socket_);
+			socket_ = invalid_socket;
+			if (path_.front() != '@') {
+				std::error_code __ec;
+				std::filesystem::remove(path_, __ec);
+			}
+		}
+
+		~server() override {
+			close();
+#ifdef PLATFORM_Windows
+			tcp::wsa_control::release();
+#endif
+		}
+	};
+}
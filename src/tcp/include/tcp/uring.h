@@ -0,0 +1,329 @@
+#pragma once
+#include "tcp/endpoint.h"
+
+#if defined(PLATFORM_Linux) && __has_include(<linux/io_uring.h>)
+
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+namespace network::tcp {
+
+	/**
+	 * \brief Completion-based socket I/O on io_uring, alongside the blocking and reactor-driven paths.
+	 *
+	 * Operations (`recv`, `send`, `accept`) are queued without a system call and submitted together by `submit()` or
+	 * `run_once()`, which also waits for completions and invokes their handlers. Sockets are taken as native handles,
+	 * e.g. `endpoint::native_handle()` and `server::native_handle()`. Not thread-safe: use one ring per thread.
+	 */
+	class uring final {
+	public:
+		struct completion {
+
+			/// Octets transferred, the accepted socket, or a negated `errno` value.
+			std::int32_t result;
+
+			std::uint32_t flags;
+
+			/// Whether a multishot operation stays armed and will complete again.
+			[[nodiscard]] bool more() const {
+				return flags & IORING_CQE_F_MORE;
+			}
+
+			/// The provided buffer the kernel picked for a receive.
+			[[nodiscard]] std::optional<std::uint16_t> buffer() const {
+				if (!(flags & IORING_CQE_F_BUFFER))
+					return std::nullopt;
+				return static_cast<std::uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT);
+			}
+		};
+
+		using handler = std::function<void(const completion&)>;
+
+		/**
+		 * \brief Receive buffers registered with the kernel as a provided buffer ring.
+		 *
+		 * Receives on the group take a buffer only once data arrives, so idle connections hold no memory. A buffer
+		 * must be handed back with `recycle()` after its data has been consumed; once all are taken, receives fail
+		 * with `-ENOBUFS`.
+		 */
+		class buffer_group {
+
+			friend class uring;
+
+			std::uint16_t id_;
+
+			std::uint16_t count_;
+
+			std::size_t size_;
+
+			std::unique_ptr<std::uint8_t[]> storage_;
+
+			io_uring_buf_ring* ring_;
+
+			std::uint16_t tail_ = 0;
+
+			buffer_group(const int ring_fd, const std::uint16_t id, const std::uint16_t count, const std::size_t size)
+				: id_(id), count_(count), size_(size), storage_(std::make_unique_for_overwrite<std::uint8_t[]>(count * size)) {
+				if (!count || count & (count - 1))
+					throw std::invalid_argument("uring: buffer count must be a power of two");
+				const auto __p = mmap(nullptr, count * sizeof(io_uring_buf), PROT_READ | PROT_WRITE,
+					MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+				if (__p == MAP_FAILED)
+					throw std::runtime_error(std::format("uring: mmap gives error {}", errno));
+				ring_ = static_cast<io_uring_buf_ring*>(__p);
+				io_uring_buf_reg __reg{};
+				__reg.ring_addr = reinterpret_cast<std::uint64_t>(ring_);
+				__reg.ring_entries = count;
+				__reg.bgid = id;
+				if (syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_PBUF_RING, &__reg, 1) < 0) {
+					munmap(ring_, count_ * sizeof(io_uring_buf));
+					throw std::runtime_error(std::format("uring: registering buffer ring gives error {}", errno));
+				}
+				for (std::uint16_t i = 0; i < count; ++i)
+					recycle(i);
+			}
+
+		public:
+			buffer_group(const buffer_group&) = delete;
+
+			buffer_group& operator=(const buffer_group&) = delete;
+
+			~buffer_group() {
+				munmap(ring_, count_ * sizeof(io_uring_buf));
+			}
+
+			[[nodiscard]] std::uint16_t id() const {
+				return id_;
+			}
+
+			/// The first `length` octets of buffer `bid`, as filled by a completed receive.
+			[[nodiscard]] byte_string_view data(const std::uint16_t bid, const std::size_t length) const {
+				return {storage_.get() + bid * size_, std::min(length, size_)};
+			}
+
+			/// Returns buffer `bid` to the kernel.
+			void recycle(const std::uint16_t bid) {
+				// io_uring_buf_ring::bufs is misplaced in C++, where its empty-struct flexible array idiom takes space;
+				// the entries start at the ring itself, and resv of the first one holds the tail
+				auto& __b = reinterpret_cast<io_uring_buf*>(ring_)[tail_ & (count_ - 1)];
+				__b.addr = reinterpret_cast<std::uint64_t>(storage_.get() + bid * size_);
+				__b.len = static_cast<std::uint32_t>(size_);
+				__b.bid = bid;
+				std::atomic_ref{ring_->tail}.store(++tail_, std::memory_order_release);
+			}
+		};
+
+		explicit uring(const unsigned entries = 256) {
+			io_uring_params __p{};
+			fd_ = static_cast<int>(syscall(__NR_io_uring_setup, entries, &__p));
+			if (fd_ < 0)
+				throw std::runtime_error(std::format("uring: io_uring_setup gives error {}", errno));
+			sq_size_ = __p.sq_off.array + __p.sq_entries * sizeof(unsigned);
+			cq_size_ = __p.cq_off.cqes + __p.cq_entries * sizeof(io_uring_cqe);
+			if (__p.features & IORING_FEAT_SINGLE_MMAP)
+				sq_size_ = cq_size_ = std::max(sq_size_, cq_size_);
+			sq_ring_ = map_(sq_size_, IORING_OFF_SQ_RING);
+			cq_ring_ = __p.features & IORING_FEAT_SINGLE_MMAP ? sq_ring_ : map_(cq_size_, IORING_OFF_CQ_RING);
+			sqes_ = static_cast<io_uring_sqe*>(map_(__p.sq_entries * sizeof(io_uring_sqe), IORING_OFF_SQES));
+			sqes_size_ = __p.sq_entries * sizeof(io_uring_sqe);
+
+			const auto __sq = static_cast<std::uint8_t*>(sq_ring_), __cq = static_cast<std::uint8_t*>(cq_ring_);
+			sq_head_ = reinterpret_cast<unsigned*>(__sq + __p.sq_off.head);
+			sq_tail_ = reinterpret_cast<unsigned*>(__sq + __p.sq_off.tail);
+			sq_mask_ = *reinterpret_cast<unsigned*>(__sq + __p.sq_off.ring_mask);
+			sq_entries_ = __p.sq_entries;
+			sq_array_ = reinterpret_cast<unsigned*>(__sq + __p.sq_off.array);
+			cq_head_ = reinterpret_cast<unsigned*>(__cq + __p.cq_off.head);
+			cq_tail_ = reinterpret_cast<unsigned*>(__cq + __p.cq_off.tail);
+			cq_mask_ = *reinterpret_cast<unsigned*>(__cq + __p.cq_off.ring_mask);
+			cqes_ = reinterpret_cast<io_uring_cqe*>(__cq + __p.cq_off.cqes);
+			local_tail_ = *sq_tail_;
+		}
+
+		uring(const uring&) = delete;
+
+		uring& operator=(const uring&) = delete;
+
+		~uring() {
+			groups_.clear();
+			munmap(sqes_, sqes_size_);
+			if (cq_ring_ != sq_ring_)
+				munmap(cq_ring_, cq_size_);
+			munmap(sq_ring_, sq_size_);
+			::close(fd_);
+		}
+
+		/// Registers `count` (a power of two) receive buffers of `size` octets each under group `id`.
+		buffer_group& add_buffer_group(const std::uint16_t id, const std::uint16_t count, const std::size_t size) {
+			auto& __g = groups_[id];
+			__g.reset(new buffer_group(fd_, id, count, size));
+			return *__g;
+		}
+
+		/// Receives into `buffer`, which must stay alive until the completion.
+		void recv(const socket_t socket, const std::span<std::uint8_t> buffer, handler h) {
+			auto& __e = next_(std::move(h));
+			__e.opcode = IORING_OP_RECV;
+			__e.fd = socket;
+			__e.addr = reinterpret_cast<std::uint64_t>(buffer.data());
+			__e.len = static_cast<std::uint32_t>(buffer.size());
+		}
+
+		/**
+		 * \brief Receives into a buffer the kernel picks from `group` once data arrives; see `completion::buffer()`.
+		 * \param multishot Keep receiving until an error, the end of the stream or `cancel()`.
+		 */
+		void recv(const socket_t socket, const buffer_group& group, handler h, const bool multishot = false) {
+			auto& __e = next_(std::move(h));
+			__e.opcode = IORING_OP_RECV;
+			__e.flags = IOSQE_BUFFER_SELECT;
+			__e.fd = socket;
+			__e.buf_group = group.id();
+			if (multishot)
+				__e.ioprio = IORING_RECV_MULTISHOT;
+		}
+
+		/// Sends `data`, which must stay alive until the completion; the result may be a short count.
+		void send(const socket_t socket, const byte_string_view data, handler h) {
+			auto& __e = next_(std::move(h));
+			__e.opcode = IORING_OP_SEND;
+			__e.fd = socket;
+			__e.addr = reinterpret_cast<std::uint64_t>(data.data());
+			__e.len = static_cast<std::uint32_t>(data.size());
+		}
+
+		/**
+		 * \brief Accepts a connection on listening socket `socket`; the result is the new socket.
+		 * \param multishot Keep accepting, one completion per connection, until an error or `cancel()`.
+		 */
+		void accept(const socket_t socket, handler h, const bool multishot = false) {
+			auto& __e = next_(std::move(h));
+			__e.opcode = IORING_OP_ACCEPT;
+			__e.fd = socket;
+			__e.accept_flags = SOCK_CLOEXEC;
+			if (multishot)
+				__e.ioprio = IORING_ACCEPT_MULTISHOT;
+		}
+
+		/// Cancels every pending operation on `socket`; their handlers complete with `-ECANCELED`.
+		void cancel(const socket_t socket) {
+			auto& __e = next_({});
+			__e.opcode = IORING_OP_ASYNC_CANCEL;
+			__e.fd = socket;
+			__e.cancel_flags = IORING_ASYNC_CANCEL_ALL | IORING_ASYNC_CANCEL_FD;
+		}
+
+		/// Operations queued or in flight whose handlers have not run for the last time yet.
+		[[nodiscard]] std::size_t pending() const {
+			return handlers_.size();
+		}
+
+		/// Submits the queued operations in one system call; returns how many were submitted.
+		std::size_t submit() {
+			return enter_(0, 0);
+		}
+
+		/**
+		 * \brief Submits the queued operations, waits for at least one completion if `wait`, and runs the handlers of
+		 * all completions available.
+		 * \return The number of completions handled.
+		 */
+		std::size_t run_once(const bool wait = true) {
+			if (wait && !handlers_.empty() && cq_ready_() == 0)
+				enter_(1, IORING_ENTER_GETEVENTS);
+			else
+				submit();
+			std::size_t __handled = 0;
+			for (unsigned __head = *cq_head_; __head != std::atomic_ref{*cq_tail_}.load(std::memory_order_acquire); ) {
+				const auto __cqe = cqes_[__head & cq_mask_];
+				std::atomic_ref{*cq_head_}.store(++__head, std::memory_order_release);
+				const auto __it = handlers_.find(__cqe.user_data);
+				if (__it == handlers_.end())
+					continue;
+				const completion __c{__cqe.res, __cqe.flags};
+				// taken out first, as the handler may queue further operations
+				handler __h;
+				if (__c.more())
+					__h = __it->second;
+				else {
+					__h = std::move(__it->second);
+					handlers_.erase(__it);
+				}
+				__h(__c);
+				++__handled;
+			}
+			return __handled;
+		}
+
+	private:
+		int fd_;
+
+		void* sq_ring_, * cq_ring_;
+
+		std::size_t sq_size_, cq_size_, sqes_size_;
+
+		io_uring_sqe* sqes_;
+
+		unsigned* sq_head_, * sq_tail_, * sq_array_, sq_mask_, sq_entries_;
+
+		unsigned* cq_head_, * cq_tail_, cq_mask_;
+
+		io_uring_cqe* cqes_;
+
+		/// Tail of the submission queue including entries not yet published to the kernel.
+		unsigned local_tail_;
+
+		std::uint64_t next_id_ = 1;
+
+		std::unordered_map<std::uint64_t, handler> handlers_;
+
+		std::unordered_map<std::uint16_t, std::unique_ptr<buffer_group>> groups_;
+
+		void* map_(const std::size_t size, const std::uint64_t offset) const {
+			const auto __p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, offset);
+			if (__p == MAP_FAILED)
+				throw std::runtime_error(std::format("uring: mmap gives error {}", errno));
+			return __p;
+		}
+
+		[[nodiscard]] unsigned cq_ready_() const {
+			return std::atomic_ref{*cq_tail_}.load(std::memory_order_acquire) - *cq_head_;
+		}
+
+		/// Claims a submission entry, flushing the queue to the kernel first if it is full.
+		io_uring_sqe& next_(handler h) {
+			if (local_tail_ - std::atomic_ref{*sq_head_}.load(std::memory_order_acquire) == sq_entries_)
+				submit();
+			const auto __index = local_tail_++ & sq_mask_;
+			auto& __e = sqes_[__index];
+			std::memset(&__e, 0, sizeof __e);
+			sq_array_[__index] = __index;
+			if (h) {
+				__e.user_data = next_id_;
+				handlers_.emplace(next_id_++, std::move(h));
+			}
+			return __e;
+		}
+
+		std::size_t enter_(const unsigned min_complete, const unsigned flags) {
+			const auto __queued = local_tail_ - std::atomic_ref{*sq_head_}.load(std::memory_order_acquire);
+			std::atomic_ref{*sq_tail_}.store(local_tail_, std::memory_order_release);
+			for (;;) {
+				const auto __r = syscall(__NR_io_uring_enter, fd_, __queued, min_complete, flags, nullptr, 0);
+				if (__r >= 0)
+					return __r;
+				if (errno != EINTR)
+					throw std::runtime_error(std::format("uring: io_uring_enter gives error {}", errno));
+			}
+		}
+	};
+}
+
+#endif
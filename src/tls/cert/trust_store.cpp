@@ -0,0 +1,161 @@
+#include "tls/cert/trust_store.h"
+#include "tls-record/alert.h"
+#include "encoding/pem.h"
+#include "crypto/sha2.h"
+#include "internal/utils.h"
+#include <algorithm>
+#include <ranges>
+
+namespace network::tls::x509 {
+
+	chain_cache::chain_cache(const std::size_t capacity): capacity_(capacity) {
+	}
+
+	byte_string chain_cache::key(const std::vector<byte_string>& chain, const std::string_view host) {
+		byte_string __data;
+		internal::write(std::endian::big, __data, static_cast<std::uint32_t>(host.size()));
+		__data.append(reinterpret_cast<const std::uint8_t*>(host.data()), host.size());
+		for (const auto& __c: chain) {
+			internal::write(std::endian::big, __data, static_cast<std::uint32_t>(__c.size()));
+			__data += __c;
+		}
+		return sha_256::hash({__data, std::nullopt, std::endian::big}).to_bytestring(std::endian::big);
+	}
+
+	bool chain_cache::contains(const byte_string& key, const std::chrono::sys_seconds now) {
+		std::lock_guard lock(mutex_);
+		const auto it = entries_.find(key);
+		if (it == entries_.end())
+			return false;
+		if (now <= it->second)
+			return true;
+		entries_.erase(it);
+		return false;
+	}
+
+	void chain_cache::store(byte_string key, const std::chrono::sys_seconds expiry) {
+		std::lock_guard lock(mutex_);
+		if (!capacity_)
+			return;
+		if (entries_.size() >= capacity_) {
+			const auto now = std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now());
+			std::erase_if(entries_, [&](const auto& __e) { return __e.second < now; });
+			if (entries_.size() >= capacity_)
+				entries_.erase(entries_.begin());
+		}
+		entries_.insert_or_assign(std::move(key), expiry);
+	}
+
+	void chain_cache::clear() {
+		std::lock_guard lock(mutex_);
+		entries_.clear();
+	}
+
+	std::size_t chain_cache::size() {
+		std::lock_guard lock(mutex_);
+		return entries_.size();
+	}
+
+	void trust_store::add(certificate __c) {
+		auto __subject = __c.subject;
+		anchors_.emplace(std::move(__subject), std::move(__c));
+	}
+
+	void trust_store::add_pem(const std::string_view bundle) {
+		using std::literals::operator ""sv;
+		constexpr auto footer = "-----END CERTIFICATE-----\n"sv;
+		for (std::size_t __pos = 0; ; ) {
+			const auto __begin = bundle.find("-----BEGIN CERTIFICATE-----", __pos);
+			if (__begin == std::string_view::npos)
+				break;
+			const auto __end = bundle.find(footer, __begin);
+			if (__end == std::string_view::npos)
+				throw std::runtime_error{"x509: certificate in bundle does not end with footer"};
+			__pos = __end + footer.size();
+			add(certificate{encoding::pem::from(bundle.substr(__begin, __pos - __begin))});
+		}
+	}
+
+	const certificate* trust_store::find_anchor_(const certificate& __c) const {
+		// the chain may include the anchor itself
+		for (auto [it, end] = anchors_.equal_range(__c.subject); it != end; ++it)
+			if (it->second.encoding == __c.encoding)
+				return &it->second;
+		for (auto [it, end] = anchors_.equal_range(__c.issuer); it != end; ++it)
+			if (__c.signed_by(it->second))
+				return &it->second;
+		return nullptr;
+	}
+
+	certificate trust_store::verify(const std::vector<byte_string>& chain, const std::string_view host,
+	                                const std::chrono::system_clock::time_point now) {
+		if (chain.empty())
+			throw alert::bad_certificate("empty certificate chain");
+		const auto __now = std::chrono::floor<std::chrono::seconds>(now);
+		const auto __key = chain_cache::key(chain, host);
+		const auto parse = [](const byte_string& __der) {
+			try {
+				return certificate{__der};
+			} catch (const std::runtime_error& __e) {
+				throw alert::bad_certificate(__e.what());
+			}
+		};
+		auto __leaf = parse(chain.front());
+		if (cache_.contains(__key, __now))
+			return __leaf;
+		if (!host.empty() && !__leaf.matches_host(host))
+			throw alert::bad_certificate("certificate does not match host name");
+
+		std::vector<certificate> __presented;
+		__presented.reserve(chain.size() - 1);
+		for (const auto& __der: chain | std::views::drop(1))
+			__presented.push_back(parse(__der));
+		std::vector<bool> __used(__presented.size());
+
+		auto __expiry = __leaf.not_after;
+		const auto check_period = [&](const certificate& __c) {
+			if (__now < __c.not_before || __now > __c.not_after)
+				throw alert::certificate_expired();
+			__expiry = std::min(__expiry, __c.not_after);
+		};
+		// `__below` counts certificates beneath `__c` in the path
+		const auto check_issuer = [](const certificate& __c, const std::size_t __below) {
+			if (!__c.ca || !__c.key_cert_sign)
+				throw alert::bad_certificate("issuer is not a certificate authority");
+			if (__c.path_length && __below - 1 > __c.path_length.value())
+				throw alert::bad_certificate("path length constraint exceeded");
+		};
+
+		try {
+			const certificate* __current = &__leaf;
+			for (std::size_t __depth = 0; ; ++__depth) {
+				if (__depth >= max_depth)
+					throw alert::bad_certificate("certificate chain too long");
+				check_period(*__current);
+				if (__depth)
+					check_issuer(*__current, __depth);
+				if (const auto __anchor = find_anchor_(*__current)) {
+					check_period(*__anchor);
+					if (__anchor->encoding != __current->encoding)
+						check_issuer(*__anchor, __depth + 1);
+					break;
+				}
+				const certificate* __issuer = nullptr;
+				for (std::size_t i = 0; i < __presented.size() && !__issuer; ++i)
+					if (!__used[i] && __presented[i].subject == __current->issuer && __current->signed_by(__presented[i])) {
+						__used[i] = true;
+						__issuer = &__presented[i];
+					}
+				if (!__issuer)
+					throw alert::unknown_ca();
+				__current = __issuer;
+			}
+		} catch (const std::runtime_error& __e) {
+			if (dynamic_cast<const alert*>(&__e))
+				throw;
+			throw alert::unsupported_certificate(__e.what());
+		}
+		cache_.store(__key, __expiry);
+		return __leaf;
+	}
+}
@@ -0,0 +1,344 @@
+#include "tls/cert/x509.h"
+#include "encoding/x690.h"
+#include "crypto/rsa.h"
+#include "crypto/ecc.h"
+#include "crypto/sha2.h"
+#include "internal/utils.h"
+#include <format>
+
+using namespace encoding;
+
+namespace {
+
+	/// Reads from a view without copying the remaining input, so elements can be decoded in place.
+	struct view_stream final: istream {
+
+		byte_string_view source;
+
+		explicit view_stream(const byte_string_view __s): source(__s) {
+		}
+
+		std::uint8_t read() override {
+			if (source.empty())
+				throw std::runtime_error{"x509: unexpected end of data"};
+			const auto __c = source.front();
+			source.remove_prefix(1);
+			return __c;
+		}
+
+		byte_string read(const std::size_t count) override {
+			if (count > source.size())
+				throw std::runtime_error{"x509: unexpected end of data"};
+			byte_string __r{source.substr(0, count)};
+			source.remove_prefix(count);
+			return __r;
+		}
+
+		void skip(const std::size_t count) override {
+			if (count > source.size())
+				throw std::runtime_error{"x509: unexpected end of data"};
+			source.remove_prefix(count);
+		}
+	};
+
+	struct element {
+
+		x690::content_head head;
+
+		/// Identifier, length and contents octets.
+		byte_string_view encoding;
+
+		byte_string_view content;
+
+		[[nodiscard]] bool is(const x690::tag_class_t tag_class, const std::size_t tag) const {
+			return head.tag_class == tag_class && head.tag == tag;
+		}
+	};
+
+	/// Splits a run of DER elements.
+	struct der_reader {
+
+		byte_string_view source;
+
+		[[nodiscard]] bool empty() const {
+			return source.empty();
+		}
+
+		element next() {
+			view_stream __s{source};
+			const auto [head, header_size] = x690::parse_head(__s);
+			if (!head.size)
+				throw std::runtime_error{"x509: indefinite length is not allowed in DER"};
+			const auto __size = head.size.value();
+			if (__size > source.size() - header_size)
+				throw std::runtime_error{"x509: element exceeds its container"};
+			element __e{head, source.substr(0, header_size + __size), source.substr(header_size, __size)};
+			source.remove_prefix(header_size + __size);
+			return __e;
+		}
+
+		element next(const x690::tag_t tag) {
+			auto __e = next();
+			if (!__e.is(x690::tag_class_t::universal, static_cast<std::size_t>(tag)))
+				throw std::runtime_error{std::format("x509: expected universal tag {}, got {}", static_cast<std::size_t>(tag), __e.head.tag)};
+			return __e;
+		}
+
+		[[nodiscard]] bool peek(const x690::tag_class_t tag_class, const std::size_t tag) const {
+			return !empty() && static_cast<x690::tag_class_t>(source.front() >> 6) == tag_class
+				&& (source.front() & 0x1f) == tag;
+		}
+
+		[[nodiscard]] bool peek(const x690::tag_t tag) const {
+			return peek(x690::tag_class_t::universal, static_cast<std::size_t>(tag));
+		}
+	};
+
+	template<class T>
+	auto decode(const element& __e) {
+		view_stream __s{__e.encoding};
+		return x690::parse<T>(__s);
+	}
+
+	std::string dotted(const element& __e) {
+		std::string __r;
+		for (const auto __c: decode<x690::object_identifier>(__e).components)
+			__r += std::format("{}{}", __r.empty() ? "" : ".", __c);
+		return __r;
+	}
+
+	/// Algorithm of an AlgorithmIdentifier; parameters are ignored.
+	std::string algorithm_of(const element& __e) {
+		der_reader __r{__e.content};
+		return dotted(__r.next(x690::tag_t::object_id));
+	}
+
+	std::size_t small_integer(const element& __e) {
+		if (__e.content.empty() || __e.content.size() > sizeof(std::size_t) || __e.content.front() & 0x80)
+			throw std::runtime_error{"x509: integer out of range"};
+		std::size_t __v = 0;
+		for (const auto __c: __e.content)
+			__v = __v << 8 | __c;
+		return __v;
+	}
+
+	/// UTCTime (YYMMDDHHMMSSZ) or GeneralizedTime (YYYYMMDDHHMMSSZ), the only forms RFC 5280 permits.
+	std::chrono::sys_seconds parse_time(const element& __e) {
+		const std::string_view __s{reinterpret_cast<const char*>(__e.content.data()), __e.content.size()};
+		const bool utc = __e.is(x690::tag_class_t::universal, static_cast<std::size_t>(x690::tag_t::utc_time));
+		if (!utc && !__e.is(x690::tag_class_t::universal, static_cast<std::size_t>(x690::tag_t::generalized_time)))
+			throw std::runtime_error{"x509: time must be UTCTime or GeneralizedTime"};
+		if (__s.size() != (utc ? 13 : 15) || __s.back() != 'Z')
+			throw std::runtime_error{"x509: time must be in UTC with seconds"};
+		std::size_t __pos = 0;
+		const auto digits = [&](const std::size_t __n) {
+			int __v = 0;
+			for (std::size_t i = 0; i < __n; ++i, ++__pos) {
+				if (__s[__pos] < '0' || __s[__pos] > '9')
+					throw std::runtime_error{"x509: malformed time"};
+				__v = __v * 10 + (__s[__pos] - '0');
+			}
+			return __v;
+		};
+		int __year = digits(utc ? 2 : 4);
+		if (utc)
+			__year += __year < 50 ? 2000 : 1900;
+		const auto __month = digits(2), __day = digits(2), __hour = digits(2), __minute = digits(2), __second = digits(2);
+		const std::chrono::year_month_day __date{
+			std::chrono::year{__year}, std::chrono::month(__month), std::chrono::day(__day)};
+		if (!__date.ok() || __hour > 23 || __minute > 59 || __second > 59)
+			throw std::runtime_error{"x509: malformed time"};
+		return std::chrono::sys_days{__date} + std::chrono::hours{__hour} + std::chrono::minutes{__minute}
+			+ std::chrono::seconds{__second};
+	}
+
+	crypto::rsa::public_key rsa_key(const byte_string_view __key) {
+		der_reader __outer{__key};
+		der_reader __r{__outer.next(x690::tag_t::sequence).content};
+		auto __n = decode<x690::integer>(__r.next(x690::tag_t::integer));
+		auto __e = decode<x690::integer>(__r.next(x690::tag_t::integer));
+		return {std::move(__n), std::move(__e)};
+	}
+
+	byte_string sha256(const byte_string_view data) {
+		return sha_256::hash({data, std::nullopt, std::endian::big}).to_bytestring(std::endian::big);
+	}
+
+	byte_string sha384(const byte_string_view data) {
+		return sha_384::hash({data, std::nullopt, std::endian::big}).to_bytestring(std::endian::big);
+	}
+
+	// DER of DigestInfo up to the digest itself (RFC 8017, section 9.2, note 1)
+	constexpr std::uint8_t sha256_digest_info[] {
+		0x30, 0x31, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x01, 0x05, 0x00, 0x04, 0x20};
+
+	constexpr std::uint8_t sha384_digest_info[] {
+		0x30, 0x41, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x02, 0x05, 0x00, 0x04, 0x30};
+
+	bool rsa_pkcs1(const network::tls::x509::public_key_info& signer, const byte_string_view prefix,
+	               const crypto::rsa::hash_function& hash, const byte_string_view data, const byte_string_view signature) {
+		if (signer.algorithm != network::tls::x509::oid::rsa_encryption)
+			return false;
+		byte_string __info{prefix};
+		__info += hash(data);
+		return crypto::rsa::verify_pkcs1_v1_5(rsa_key(signer.key), __info, signature);
+	}
+
+	bool rsa_pss(const network::tls::x509::public_key_info& signer, const crypto::rsa::hash_function& hash,
+	             const byte_string_view data, const byte_string_view signature) {
+		if (signer.algorithm != network::tls::x509::oid::rsa_encryption)
+			return false;
+		return crypto::rsa::verify_pss(rsa_key(signer.key), hash(data), hash, signature);
+	}
+
+	/// `signature` is a DER Ecdsa-Sig-Value (RFC 3279, section 2.2.3), as in both certificates and TLS.
+	bool ecdsa_p256(const network::tls::x509::public_key_info& signer, const crypto::rsa::hash_function& hash,
+	                const byte_string_view data, const byte_string_view signature) {
+		using namespace network::tls::x509;
+		if (signer.algorithm != oid::ec_public_key)
+			return false;
+		if (signer.parameters != oid::prime256v1)
+			throw std::runtime_error{std::format("x509: unsupported curve {}", signer.parameters)};
+		der_reader __outer{signature};
+		der_reader __sig{__outer.next(x690::tag_t::sequence).content};
+		const auto __r = __sig.next(x690::tag_t::integer).content, __s = __sig.next(x690::tag_t::integer).content;
+		return crypto::ecc::p256_verify(signer.key, hash(data), __r, __s);
+	}
+}
+
+namespace network::tls::x509 {
+
+	certificate::certificate(byte_string der): encoding(std::move(der)) {
+		der_reader __outer{encoding};
+		const auto __cert = __outer.next(x690::tag_t::sequence);
+		if (!__outer.empty())
+			throw std::runtime_error{"x509: trailing data after certificate"};
+
+		der_reader __c{__cert.content};
+		const auto __tbs = __c.next(x690::tag_t::sequence);
+		tbs_offset_ = __tbs.encoding.data() - encoding.data();
+		tbs_size_ = __tbs.encoding.size();
+		signature_algorithm = algorithm_of(__c.next(x690::tag_t::sequence));
+		auto __sig = decode<x690::bit_string>(__c.next(x690::tag_t::bitstring));
+		if (__sig.unused_bits)
+			throw std::runtime_error{"x509: signature must be octet aligned"};
+		signature = std::move(__sig.data);
+
+		der_reader __t{__tbs.content};
+		if (__t.peek(x690::tag_class_t::context_specific, 0))
+			__t.next();
+		__t.next(x690::tag_t::integer);
+		if (algorithm_of(__t.next(x690::tag_t::sequence)) != signature_algorithm)
+			throw std::runtime_error{"x509: signature algorithms do not match"};
+		issuer = byte_string{__t.next(x690::tag_t::sequence).encoding};
+		der_reader __validity{__t.next(x690::tag_t::sequence).content};
+		not_before = parse_time(__validity.next());
+		not_after = parse_time(__validity.next());
+		subject = byte_string{__t.next(x690::tag_t::sequence).encoding};
+
+		der_reader __spki{__t.next(x690::tag_t::sequence).content};
+		der_reader __alg{__spki.next(x690::tag_t::sequence).content};
+		public_key.algorithm = dotted(__alg.next(x690::tag_t::object_id));
+		if (__alg.peek(x690::tag_t::object_id))
+			public_key.parameters = dotted(__alg.next());
+		public_key.key = decode<x690::bit_string>(__spki.next(x690::tag_t::bitstring)).data;
+
+		while (!__t.empty()) {
+			const auto __e = __t.next();
+			if (!__e.is(x690::tag_class_t::context_specific, 3))
+				continue;
+			der_reader __wrapper{__e.content};
+			for (der_reader __exts{__wrapper.next(x690::tag_t::sequence).content}; !__exts.empty(); ) {
+				der_reader __ext{__exts.next(x690::tag_t::sequence).content};
+				const auto __id = dotted(__ext.next(x690::tag_t::object_id));
+				const bool __critical = __ext.peek(x690::tag_t::boolean) && decode<x690::boolean>(__ext.next());
+				const auto __value = __ext.next(x690::tag_t::octetstring).content;
+				if (__id == oid::basic_constraints) {
+					der_reader __v{__value};
+					der_reader __bc{__v.next(x690::tag_t::sequence).content};
+					if (__bc.peek(x690::tag_t::boolean))
+						ca = decode<x690::boolean>(__bc.next());
+					if (__bc.peek(x690::tag_t::integer))
+						path_length = small_integer(__bc.next());
+				} else if (__id == oid::key_usage) {
+					der_reader __v{__value};
+					const auto __bits = decode<x690::bit_string>(__v.next(x690::tag_t::bitstring));
+					key_cert_sign = !__bits.data.empty() && __bits.data[0] & 0x04;
+				} else if (__id == oid::subject_alt_name) {
+					der_reader __v{__value};
+					for (der_reader __names{__v.next(x690::tag_t::sequence).content}; !__names.empty(); ) {
+						const auto __name = __names.next();
+						if (__name.is(x690::tag_class_t::context_specific, 2))
+							dns_names.emplace_back(reinterpret_cast<const char*>(__name.content.data()), __name.content.size());
+					}
+				} else if (__critical)
+					throw std::runtime_error{std::format("x509: unsupported critical extension {}", __id)};
+			}
+		}
+	}
+
+	bool certificate::matches_host(const std::string_view host) const {
+		const auto __host = internal::to_lower(host);
+		for (const auto& __n: dns_names) {
+			const auto __name = internal::to_lower(__n);
+			if (__name == __host)
+				return true;
+			// the wildcard covers exactly one leftmost label
+			if (__name.starts_with("*.")) {
+				const auto __dot = __host.find('.');
+				if (__dot != std::string::npos && __dot > 0 && std::string_view{__host}.substr(__dot) == std::string_view{__name}.substr(1))
+					return true;
+			}
+		}
+		return false;
+	}
+
+	bool certificate::signed_by(const certificate& issuer_cert) const {
+		return issuer == issuer_cert.subject
+			&& verify_signature(issuer_cert.public_key, signature_algorithm, tbs(), signature);
+	}
+
+	bool verify_signature(const public_key_info& signer, const std::string_view algorithm, const byte_string_view data,
+	                      const byte_string_view signature) {
+		if (algorithm == oid::sha256_with_rsa)
+			return rsa_pkcs1(signer, {sha256_digest_info, sizeof sha256_digest_info}, sha256, data, signature);
+		if (algorithm == oid::sha384_with_rsa)
+			return rsa_pkcs1(signer, {sha384_digest_info, sizeof sha384_digest_info}, sha384, data, signature);
+		if (algorithm == oid::ecdsa_with_sha256)
+			return ecdsa_p256(signer, sha256, data, signature);
+		if (algorithm == oid::ecdsa_with_sha384)
+			return ecdsa_p256(signer, sha384, data, signature);
+		throw std::runtime_error{std::format("x509: unsupported signature algorithm {}", algorithm)};
+	}
+
+	bool verify_signature(const public_key_info& signer, const signature_scheme_t scheme, const byte_string_view data,
+	                      const byte_string_view signature) {
+		switch (scheme) {
+			case signature_scheme_t::ecdsa_secp256r1_sha256:
+				return ecdsa_p256(signer, sha256, data, signature);
+			case signature_scheme_t::rsa_pss_rsae_sha256:
+				return rsa_pss(signer, sha256, data, signature);
+			case signature_scheme_t::rsa_pss_rsae_sha384:
+				return rsa_pss(signer, sha384, data, signature);
+			case signature_scheme_t::rsa_pkcs1_sha256:
+				return rsa_pkcs1(signer, {sha256_digest_info, sizeof sha256_digest_info}, sha256, data, signature);
+			case signature_scheme_t::rsa_pkcs1_sha384:
+				return rsa_pkcs1(signer, {sha384_digest_info, sizeof sha384_digest_info}, sha384, data, signature);
+			default:
+				throw std::runtime_error{std::format("x509: unsupported signature scheme {}", scheme)};
+		}
+	}
+
+	bool supports(const signature_scheme_t scheme) {
+		switch (scheme) {
+			case signature_scheme_t::ecdsa_secp256r1_sha256:
+			case signature_scheme_t::rsa_pss_rsae_sha256:
+			case signature_scheme_t::rsa_pss_rsae_sha384:
+			case signature_scheme_t::rsa_pkcs1_sha256:
+			case signature_scheme_t::rsa_pkcs1_sha384:
+				return true;
+			default:
+				return false;
+		}
+	}
+}
@@ -9,6 +9,34 @@ namespace network::tls {
 
 	constexpr std::uint8_t finished_label[] = "finished", empty_context[] = "";
 
+	constexpr std::string_view cert_verify_label = "TLS 1.3, server CertificateVerify";
+
+	std::optional<named_group_t> group_cache::find(const std::string_view host) {
+		std::lock_guard lock(mutex_);
+		if (const auto it = groups_.find(host); it != groups_.end())
+			return it->second;
+		return std::nullopt;
+	}
+
+	void group_cache::store(const std::string_view host, const named_group_t group) {
+		std::lock_guard lock(mutex_);
+		if (const auto it = groups_.find(host); it != groups_.end())
+			it->second = group;
+		else
+			groups_.emplace(host, group);
+	}
+
+	void group_cache::erase(const std::string_view host) {
+		std::lock_guard lock(mutex_);
+		if (const auto it = groups_.find(host); it != groups_.end())
+			groups_.erase(it);
+	}
+
+	group_cache& group_cache::global() {
+		static group_cache cache;
+		return cache;
+	}
+
 	client::client(stream_client& __c, std::unique_ptr<random_source> __g)
 			: endpoint(__c, endpoint_type::client, std::move(__g)), client_(__c) {
 	}
@@ -16,8 +44,11 @@ namespace network::tls {
 	void client::connect(const std::string_view host, const uint16_t port) {
 		close();
 		reset();
+		peer_host_ = host;
 		client_.connect(host, port);
 		handshake_();
+		if (kernel_offload && !offload_())
+			std::cout << "[TLS client] kernel offload unavailable; using userspace records\n";
 	}
 
 	std::size_t client::available() {
@@ -43,7 +74,7 @@ namespace network::tls {
 			clt_hl.add(ext_type_t::key_share, std::make_unique<key_share>(extension_holder_t::client_hello, available_managers_));
 		clt_hl.add(ext_type_t::supported_groups, std::make_unique<supported_groups>(available_groups_));
 		clt_hl.add(ext_type_t::supported_versions, std::make_unique<supported_versions>(extension_holder_t::client_hello, std::initializer_list<protocol_version_t>{protocol_version_t::TLS1_3}));
-		clt_hl.add(ext_type_t::signature_algorithms, std::make_unique<signature_algorithms>(std::initializer_list<signature_scheme_t>{
+		auto __sig_algs = std::make_unique<signature_algorithms>(std::initializer_list<signature_scheme_t>{
 				signature_scheme_t::ecdsa_secp256r1_sha256,
 				signature_scheme_t::ecdsa_secp384r1_sha384,
 				signature_scheme_t::ecdsa_secp521r1_sha512,
@@ -53,7 +84,11 @@ namespace network::tls {
 				signature_scheme_t::rsa_pkcs1_sha256,
 				signature_scheme_t::rsa_pkcs1_sha384,
 				signature_scheme_t::rsa_pkcs1_sha512
-		}));
+		});
+		// when validating, only offer what the peer's signatures can be checked with
+		if (trust)
+			std::erase_if(__sig_algs->list, [](const auto __s) { return !x509::supports(__s); });
+		clt_hl.add(ext_type_t::signature_algorithms, std::move(__sig_algs));
 		clt_hl.add(ext_type_t::psk_key_exchange_modes, std::make_unique<psk_key_exchange_modes>(psk_key_exchange_modes{psk_key_exchange_mode_t::psk_dhe_ke}));
 		if (!alpn_protocols.empty())
 			clt_hl.add(ext_type_t::alpn, std::make_unique<alpn>(alpn_protocols));
@@ -63,142 +98,186 @@ namespace network::tls {
 	}
 
 	void client::handshake_() {
-		byte_string handshake_msgs, cert_verify;
-		{
-			auto ch = gen_client_hello_();
-			handshake_msgs += *ch;
-			send_(content_type_t::handshake, false, {std::move(ch)});
-		}
-		client_state_t client_state = client_state_t::wait_server_hello;
-		while (client_state != client_state_t::connected) {
-			auto record = record::extract(client_, secret_);
-			std::cout << std::format("[TLS client] got {}\n", record);
-			switch (record.type) {
-				case content_type_t::handshake:
-					for (byte_string_view __content{record.messages}; !__content.empty(); ) {
-						const auto opt_message = parse_handshake(__content, record.encrypted(), false);
-						if (!opt_message)
+		start_handshake_();
+		while (!handshake_done_())
+			handle_handshake_record_(record::extract(client_, secret_));
+	}
+
+	std::string_view client::peer_name_() const {
+		return server_name ? std::string_view{server_name.value()} : std::string_view{peer_host_};
+	}
+
+	void client::start_handshake_() {
+		handshake_msgs_.clear();
+		peer_certificate_.reset();
+		const auto cached = key_share_cache && !peer_name_().empty()
+				? key_share_cache->find(peer_name_()) : std::nullopt;
+		if (cached && available_groups_.contains(cached.value())) {
+			// offer only the share the server picked last time
+			if (auto node = available_managers_.extract(cached.value()))
+				use_group(std::move(node.mapped()));
+			else
+				use_group(cached.value());
+		} else for (const auto __g: share_groups_)
+			if (!available_managers_.contains(__g))
+				available_managers_.emplace(__g, get_key_manager(__g, *random_));
+		auto ch = gen_client_hello_();
+		handshake_msgs_ += *ch;
+		send_(content_type_t::handshake, false, {std::move(ch)});
+		client_state_ = client_state_t::wait_server_hello;
+	}
+
+	bool client::handshake_done_() const {
+		return client_state_ == client_state_t::connected;
+	}
+
+	void client::handle_handshake_record_(const record& record) {
+		std::cout << std::format("[TLS client] got {}\n", record);
+		switch (record.type) {
+			case content_type_t::handshake:
+				for (byte_string_view __content{record.messages}; !__content.empty(); ) {
+					const auto opt_message = parse_handshake(__content, record.encrypted(), false);
+					if (!opt_message)
+						break;
+					auto& handshake_msg = opt_message.value();
+					std::cout << std::format("[TLS client] got {}\n", handshake_msg);
+					switch (client_state_) {
+						case client_state_t::wait_server_hello: {
+							if (!std::holds_alternative<server_hello>(handshake_msg))
+								throw alert::unexpected_message();
+							auto& srv_hl = std::get<server_hello>(handshake_msg);
+							use_cipher(srv_hl.cipher_suite);
+							if (srv_hl.is_hello_retry_request)
+								handshake_msgs_ = message_hash(cipher(), handshake_msgs_);
+							handshake_msgs_ += srv_hl;
+
+							if (!srv_hl.extensions.contains(ext_type_t::supported_versions))
+								throw std::runtime_error("unimplemented");
+							auto& __s_sv = srv_hl.get<supported_versions>(ext_type_t::supported_versions);
+							if (!std::ranges::contains(__s_sv.versions, protocol_version_t::TLS1_3))
+								throw std::runtime_error("unimplemented");
+
+							if (!srv_hl.extensions.contains(ext_type_t::key_share))
+								throw alert::handshake_failure();
+							auto& __s_ks = srv_hl.get<key_share>(ext_type_t::key_share);
+							auto& [group, key] = *__s_ks.shares.begin();
+							std::cout << std::format("[TLS client] using group {} for key exchange\n", group);
+							if (key_share_cache && !peer_name_().empty())
+								key_share_cache->store(peer_name_(), group);
+							if (available_managers_.contains(group)) {
+								auto mgr = std::move(available_managers_.extract(group).mapped());
+								use_group(std::move(mgr));
+							} else
+								use_group(group);
+							if (srv_hl.is_hello_retry_request) {
+								auto ch = gen_client_hello_();
+								handshake_msgs_ += *ch;
+								send_(content_type_t::handshake, false, {std::move(ch)});
+							} else {
+								secret_.update_entropy_secret(pre_shared_key); // todo: should calculate before wait_server_hello?
+								key_exchange().exchange(key);
+								secret_.update_entropy_secret(key_exchange().shared_key());
+								secret_.update_handshake_key(handshake_msgs_);
+								client_state_ = client_state_t::wait_encrypted_extensions;
+							}
 							break;
-						auto& handshake_msg = opt_message.value();
-						std::cout << std::format("[TLS client] got {}\n", handshake_msg);
-						switch (client_state) {
-							case client_state_t::wait_server_hello: {
-								if (!std::holds_alternative<server_hello>(handshake_msg))
-									throw alert::unexpected_message();
-								auto& srv_hl = std::get<server_hello>(handshake_msg);
-								use_cipher(srv_hl.cipher_suite);
-								if (srv_hl.is_hello_retry_request)
-									handshake_msgs = message_hash(cipher(), handshake_msgs);
-								handshake_msgs += srv_hl;
-
-								if (!srv_hl.extensions.contains(ext_type_t::supported_versions))
-									throw std::runtime_error("unimplemented");
-								auto& __s_sv = srv_hl.get<supported_versions>(ext_type_t::supported_versions);
-								if (!std::ranges::contains(__s_sv.versions, protocol_version_t::TLS1_3))
-									throw std::runtime_error("unimplemented");
-
-								if (!srv_hl.extensions.contains(ext_type_t::key_share))
-									throw alert::handshake_failure();
-								auto& __s_ks = srv_hl.get<key_share>(ext_type_t::key_share);
-								auto& [group, key] = *__s_ks.shares.begin();
-								std::cout << std::format("[TLS client] using group {} for key exchange\n", group);
-								if (available_managers_.contains(group)) {
-									auto mgr = std::move(available_managers_.extract(group).mapped());
-									use_group(std::move(mgr));
-								} else
-									use_group(group);
-								if (srv_hl.is_hello_retry_request) {
-									auto ch = gen_client_hello_();
-									handshake_msgs += *ch;
-									send_(content_type_t::handshake, false, {std::move(ch)});
-								} else {
-									secret_.update_entropy_secret(pre_shared_key); // todo: should calculate before wait_server_hello?
-									key_exchange().exchange(key);
-									secret_.update_entropy_secret(key_exchange().shared_key());
-									secret_.update_handshake_key(handshake_msgs);
-									client_state = client_state_t::wait_encrypted_extensions;
-								}
-								break;
+						}
+						case client_state_t::wait_encrypted_extensions: {
+							if (!std::holds_alternative<encrypted_extension>(handshake_msg))
+								throw alert::unexpected_message();
+							auto& srv_enc_ext = std::get<encrypted_extension>(handshake_msg);
+							if (!alpn_protocols.empty()) {
+								if (!srv_enc_ext.extensions.contains(ext_type_t::alpn))
+									throw std::runtime_error{"server does not support ALPN"};
+								auto& __s_alpn = srv_enc_ext.get<alpn>(ext_type_t::alpn);
+								std::cout << std::format("[TLS client] ALPN selected: {}\n", __s_alpn.protocol_name_list.front());
 							}
-							case client_state_t::wait_encrypted_extensions: {
-								if (!std::holds_alternative<encrypted_extension>(handshake_msg))
-									throw alert::unexpected_message();
-								auto& srv_enc_ext = std::get<encrypted_extension>(handshake_msg);
-								if (!alpn_protocols.empty()) {
-									if (!srv_enc_ext.extensions.contains(ext_type_t::alpn))
-										throw std::runtime_error{"server does not support ALPN"};
-									auto& __s_alpn = srv_enc_ext.get<alpn>(ext_type_t::alpn);
-									std::cout << std::format("[TLS client] ALPN selected: {}\n", __s_alpn.protocol_name_list.front());
-								}
-								handshake_msgs += std::get<encrypted_extension>(handshake_msg);
-								client_state = client_state_t::wait_cert_request;
+							handshake_msgs_ += std::get<encrypted_extension>(handshake_msg);
+							client_state_ = client_state_t::wait_cert_request;
+							break;
+						}
+						case client_state_t::wait_cert_request:
+							if (std::holds_alternative<certificate_request>(handshake_msg)) {
+								client_state_ = client_state_t::wait_cert;
 								break;
 							}
-							case client_state_t::wait_cert_request:
-								if (std::holds_alternative<certificate_request>(handshake_msg)) {
-									client_state = client_state_t::wait_cert;
-									break;
-								}
-								[[fallthrough]];
-							case client_state_t::wait_cert:
-								if (!std::holds_alternative<certificate>(handshake_msg))
-									throw alert::unexpected_message();
-								handshake_msgs += std::get<certificate>(handshake_msg);
-								/* auto&& cert_verify_content
-										= std::string(64, ' ')
-												+ "TLS 1.3, server CertificateVerify"
-												+ '\0'
-												+ active_cipher().hash(handshake_msgs); */
-								client_state = client_state_t::wait_cert_verify;
-								break;
-							case client_state_t::wait_cert_verify:
-								if (!std::holds_alternative<certificate_verify>(handshake_msg))
-									throw alert::unexpected_message();
-								handshake_msgs += std::get<certificate_verify>(handshake_msg);
-								client_state = client_state_t::wait_finish;
-								break;
-							case client_state_t::wait_finish: {
-								if (!std::holds_alternative<finished>(handshake_msg))
-									throw alert::unexpected_message();
-								auto& __s_finished = std::get<finished>(handshake_msg);
-								auto& __c = cipher();
-								const auto __s_finished_key
-										= __c.HKDF_expand_label(secret_.server_traffic_secret, finished_label, empty_context, __c.digest_length);
-								if (__s_finished.verify_data != __c.HMAC_hash(__c.hash(handshake_msgs), __s_finished_key))
-									throw alert::decrypt_error("Finished.verify_data does not match");
-								handshake_msgs += __s_finished;
-								const auto __c_finished_key
-										= __c.HKDF_expand_label(secret_.client_traffic_secret, finished_label, empty_context, __c.digest_length);
-								send_(content_type_t::handshake, true, {
-									std::make_unique<finished>(__c.HMAC_hash(__c.hash(handshake_msgs), __c_finished_key))});
-
-								client_state = client_state_t::connected;
-								secret_.update_entropy_secret();
-								secret_.update_master_key(handshake_msgs);
-								secret_.update_entropy_secret();
-								break;
+							[[fallthrough]];
+						case client_state_t::wait_cert: {
+							if (!std::holds_alternative<certificate>(handshake_msg))
+								throw alert::unexpected_message();
+							auto& __s_cert = std::get<certificate>(handshake_msg);
+							if (trust) {
+								std::vector<byte_string> __chain;
+								__chain.reserve(__s_cert.certificate_list.size());
+								for (const auto& __entry: __s_cert.certificate_list)
+									__chain.push_back(__entry.data);
+								peer_certificate_ = trust->verify(__chain, peer_name_());
 							}
-							default:
+							handshake_msgs_ += __s_cert;
+							client_state_ = client_state_t::wait_cert_verify;
+							break;
+						}
+						case client_state_t::wait_cert_verify: {
+							if (!std::holds_alternative<certificate_verify>(handshake_msg))
+								throw alert::unexpected_message();
+							auto& __s_cv = std::get<certificate_verify>(handshake_msg);
+							if (peer_certificate_) {
+								const auto __scheme = __s_cv.signature_scheme;
+								if (!x509::supports(__scheme) || __scheme == signature_scheme_t::rsa_pkcs1_sha256
+										|| __scheme == signature_scheme_t::rsa_pkcs1_sha384)
+									throw alert::illegal_parameter("CertificateVerify uses a scheme that was not offered");
+								byte_string __content(64, 0x20);
+								__content.append(reinterpret_cast<const std::uint8_t*>(cert_verify_label.data()), cert_verify_label.size());
+								__content.push_back(0);
+								__content += cipher().hash(handshake_msgs_);
+								if (!x509::verify_signature(peer_certificate_->public_key, __scheme, __content, __s_cv.signature))
+									throw alert::decrypt_error("CertificateVerify signature does not match");
+							}
+							handshake_msgs_ += __s_cv;
+							client_state_ = client_state_t::wait_finish;
+							break;
+						}
+						case client_state_t::wait_finish: {
+							if (!std::holds_alternative<finished>(handshake_msg))
 								throw alert::unexpected_message();
+							auto& __s_finished = std::get<finished>(handshake_msg);
+							auto& __c = cipher();
+							const auto __s_finished_key
+									= __c.HKDF_expand_label(secret_.server_traffic_secret, finished_label, empty_context, __c.digest_length);
+							if (__s_finished.verify_data != __c.HMAC_hash(__c.hash(handshake_msgs_), __s_finished_key))
+								throw alert::decrypt_error("Finished.verify_data does not match");
+							handshake_msgs_ += __s_finished;
+							const auto __c_finished_key
+									= __c.HKDF_expand_label(secret_.client_traffic_secret, finished_label, empty_context, __c.digest_length);
+							send_(content_type_t::handshake, true, {
+								std::make_unique<finished>(__c.HMAC_hash(__c.hash(handshake_msgs_), __c_finished_key))});
+
+							client_state_ = client_state_t::connected;
+							secret_.update_entropy_secret();
+							secret_.update_master_key(handshake_msgs_);
+							secret_.update_entropy_secret();
+							break;
 						}
+						default:
+							throw alert::unexpected_message();
 					}
-					break;
-				case content_type_t::change_cipher_spec:
-					break;
-				case content_type_t::alert: {
-					const auto out = std::format("got {}", static_cast<message&&>(alert(record.messages)));
-					std::cout << std::format("[TLS client] {}\n", out);
-					throw std::runtime_error(out);
 				}
-				default:
-					throw alert::unexpected_message();
+				break;
+			case content_type_t::change_cipher_spec:
+				break;
+			case content_type_t::alert: {
+				const auto out = std::format("got {}", static_cast<message&&>(alert(record.messages)));
+				std::cout << std::format("[TLS client] {}\n", out);
+				throw std::runtime_error(out);
 			}
+			default:
+				throw alert::unexpected_message();
 		}
 	}
 
 	void client::add_group(named_group_t __g, const bool generate) {
 		if (generate)
-			available_managers_.emplace(__g, get_key_manager(__g, *random_));
+			share_groups_.insert(__g);
 		available_groups_.insert(__g);
 	}
 
@@ -7,66 +7,86 @@
 namespace network::tls {
 
 	endpoint::endpoint(stream_endpoint& __u, const endpoint_type __t, std::unique_ptr<random_source> __g)
-			: base_(__u), secret_(__t, cipher_), random_(std::move(__g)) {
+			: base_(__u), endpoint_type_(__t), secret_(__t, cipher_), random_(std::move(__g)) {
 	}
 
 	byte_string endpoint::read(const std::size_t size) {
-		byte_string read_data;
-		while (read_data.size() < size) {
-			if (const auto stored = app_data_.read(size - read_data.size()); stored.empty()) {
-				const auto record = record::extract(base_, secret_);
-				switch (record.type) {
-					case content_type_t::alert:
-						switch (alert alert{record.messages}; alert.description) {
-							case alert_description_t::close_notify:
-								close();
-								break;
-							default:
-								std::cout << std::format("[TLS client] got {}: {}\n", alert.level, alert.description);
-								break;
-						}
+		byte_string read_data(size, 0);
+		read_exact(read_data);
+		return read_data;
+	}
+
+	std::size_t endpoint::read_some(const std::span<std::uint8_t> buffer) {
+		if (buffer.empty())
+			return 0;
+		while (app_data_.empty()) {
+			if (!connected())
+				return 0;
+			handle_record_(offloaded_ ? kernel_extract_() : record::extract(base_, secret_));
+		}
+		return app_data_.read_some(buffer);
+	}
+
+	void endpoint::handle_record_(record record) {
+		switch (record.type) {
+			case content_type_t::alert:
+				switch (alert alert{record.messages}; alert.description) {
+					case alert_description_t::close_notify:
+						close();
 						break;
-					case content_type_t::application_data:
-						app_data_.append(record.messages);
+					default:
+						std::cout << std::format("[TLS client] got {}: {}\n", alert.level, alert.description);
 						break;
-					case content_type_t::handshake: {
-						byte_string_view __content = record.messages;
-						const auto __presult = parse_handshake(__content, record.encrypted(), true);
-						if (!__presult)
+				}
+				break;
+			case content_type_t::application_data:
+				app_data_.append(std::move(record.messages));
+				break;
+			case content_type_t::handshake: {
+				byte_string_view __content = record.messages;
+				const auto __presult = parse_handshake(__content, record.encrypted(), true);
+				if (!__presult)
+					break;
+				auto& __msg = __presult.value();
+				std::cout << std::format("[TLS endpoint] got {}\n", __msg);
+				if (std::holds_alternative<new_session_ticket>(__msg)) {
+					auto& peer_new_session_ticket = std::get<new_session_ticket>(__msg);
+				} else if (std::holds_alternative<key_update>(__msg)) {
+					auto& __r_key_update = std::get<key_update>(__msg);
+					switch (__r_key_update.request_update) {
+						case key_update::key_update_request::update_requested: {
+							if (offloaded_)
+								throw std::runtime_error{"[TLS endpoint] KeyUpdate is not supported after kernel offload"};
+							send_(content_type_t::handshake, true, {std::make_unique<key_update>(false)});
+							secret_.update_application_key();
 							break;
-						auto& __msg = __presult.value();
-						std::cout << std::format("[TLS endpoint] got {}\n", __msg);
-						if (std::holds_alternative<new_session_ticket>(__msg)) {
-							auto& peer_new_session_ticket = std::get<new_session_ticket>(__msg);
-						} else if (std::holds_alternative<key_update>(__msg)) {
-							auto& __r_key_update = std::get<key_update>(__msg);
-							switch (__r_key_update.request_update) {
-								case key_update::key_update_request::update_requested: {
-									send_(content_type_t::handshake, true, {std::make_unique<key_update>(false)});
-									secret_.update_application_key();
-									break;
-								}
-								case key_update::key_update_request::update_not_requested:
-									break;
-								default:
-									throw alert::unexpected_message();
-							}
 						}
-						break;
+						case key_update::key_update_request::update_not_requested:
+							break;
+						default:
+							throw alert::unexpected_message();
 					}
-					default:
-						throw std::runtime_error{"unexpected"};
 				}
-			} else
-				read_data.append(stored);
+				break;
+			}
+			default:
+				throw std::runtime_error{"unexpected"};
 		}
-		return read_data;
 	}
 
 	void endpoint::write(const byte_string_view buffer) {
-		record record{content_type_t::application_data, secret_};
-		record.messages = buffer;
-		send_(record);
+		write({&buffer, 1});
+	}
+
+	void endpoint::write(const std::span<const byte_string_view> buffers) {
+		if (offloaded_) {
+			// the kernel frames application data written to the socket
+			base_.write(buffers);
+			return;
+		}
+		const auto __sealed = record{content_type_t::application_data, secret_}.seal(buffers);
+		std::cout << std::format("[TLS endpoint] sending {} application data record(s)\n", __sealed.size());
+		base_.write(std::vector<byte_string_view>{__sealed.begin(), __sealed.end()});
 	}
 
 	void endpoint::use_group(const named_group_t ng) {
@@ -96,11 +116,12 @@ namespace network::tls {
 			finish();
 		base_.close();
 		key_exchange_.reset();
+		offloaded_ = false;
 	}
 
 	void endpoint::send_(const record& record) {
 		std::cout << std::format("[TLS endpoint] sending {}\n", record);
-		base_.write(static_cast<byte_string>(record));
+		transmit_(record);
 	}
 
 	void endpoint::send_(content_type_t type, bool encrypted, std::initializer_list<std::unique_ptr<message>> msgs) {
@@ -109,14 +130,33 @@ namespace network::tls {
 			std::cout << std::format("[TLS endpoint] sending {}\n", *__m);
 			record.messages += *__m;
 		}
-		base_.write(static_cast<byte_string>(record));
+		transmit_(record);
+	}
+
+	void endpoint::transmit_(const record& record) {
+		if (offloaded_)
+			kernel_send_(record.type, record.messages);
+		else {
+			const auto __sealed = record.seal();
+			base_.write(std::vector<byte_string_view>{__sealed.begin(), __sealed.end()});
+		}
+	}
+
+	std::size_t endpoint::send_file(const int fd, const std::uint64_t offset, const std::size_t length) {
+		if (offloaded_)
+			return base_.send_file(fd, offset, length);
+		return ostream::send_file(fd, offset, length);
+	}
+
+	void endpoint::cork(const bool enable) {
+		base_.cork(enable);
 	}
 
 	std::uint8_t endpoint::read() {
-		const auto data = read(1);
-		if (data.empty())
+		std::uint8_t octet;
+		if (!read_some({&octet, 1}))
 			throw std::runtime_error{"read failed"};
-		return data[0];
+		return octet;
 	}
 
 	void endpoint::write(const std::uint8_t octet) {
@@ -0,0 +1,74 @@
+#include "tls/engine.h"
+
+namespace network::tls {
+
+	engine::engine(std::unique_ptr<random_source> __g)
+			: session_(transport_, std::move(__g)) {
+	}
+
+	void engine::start() {
+		session_.close();
+		session_.reset();
+		transport_.output.clear();
+		transport_.connect({}, 0);
+		input_.clear();
+		session_.start_handshake_();
+	}
+
+	void engine::feed(const byte_string_view ciphertext) {
+		if (closed())
+			return;
+		input_ += ciphertext;
+		byte_string_view pending{input_};
+		while (!closed()) {
+			auto record = record::parse(pending, session_.secret_);
+			if (!record)
+				break;
+			if (session_.handshake_done_())
+				session_.handle_record_(std::move(record.value()));
+			else
+				session_.handle_handshake_record_(record.value());
+		}
+		input_.erase(0, input_.size() - pending.size());
+	}
+
+	byte_string engine::take_output() {
+		byte_string __r;
+		std::swap(__r, transport_.output);
+		return __r;
+	}
+
+	void engine::write(const byte_string_view plaintext) {
+		if (!handshake_done())
+			throw std::runtime_error("tls engine: handshake not completed");
+		session_.write(plaintext);
+	}
+
+	byte_string engine::read(const std::size_t max) {
+		return session_.app_data_.read(max);
+	}
+
+	void engine::close() {
+		session_.close();
+	}
+
+	bool engine::handshake_done() const {
+		return session_.handshake_done_();
+	}
+
+	bool engine::closed() const {
+		return !transport_.connected();
+	}
+
+	bool engine::want_read() const {
+		return !closed();
+	}
+
+	bool engine::want_write() const {
+		return !transport_.output.empty();
+	}
+
+	std::size_t engine::plaintext_available() const {
+		return session_.app_data_.size();
+	}
+}
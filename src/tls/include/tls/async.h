@@ -0,0 +1,103 @@
+#pragma once
+#include "tls/engine.h"
+#include "tcp/async.h"
+
+#ifdef PLATFORM_Linux
+
+namespace network::tls {
+
+	/**
+	 * \brief TLS client whose operations are awaitable, resumed by a `tcp::reactor`.
+	 *
+	 * Records are produced and consumed by an `engine`; this class only moves ciphertext between it and the socket,
+	 * so a handshake, request and response can be written as straight-line coroutine code.
+	 */
+	class async_client final {
+	public:
+		explicit async_client(tcp::reactor& loop, std::unique_ptr<random_source> __g = std::make_unique<mt19937_uniform>())
+			: loop_(loop), engine_(std::move(__g)) {
+		}
+
+		/// The underlying session, used to configure groups, cipher suites, ALPN and server name.
+		client& session() {
+			return engine_.session();
+		}
+
+		/// Connects to `host` and performs the handshake; `host` is the server name unless one is configured.
+		task<void> async_connect(const std::string host, const tcp_port_t port) {
+			transport_.reset();
+			co_await tcp::async_connect(loop_, socket_, host, port);
+			transport_.emplace(loop_, socket_);
+			if (!session().server_name)
+				session().server_name = host;
+			engine_.start();
+			while (!engine_.handshake_done()) {
+				co_await flush_();
+				// awaited on a line of its own: GCC 12 miscompiles co_await inside a negation
+				const bool __received = co_await fill_();
+				if (!__received)
+					throw std::runtime_error("tls: connection closed during handshake");
+			}
+			co_await flush_();
+		}
+
+		/// Reads decrypted data, waiting for at least one octet; 0 once the session is closed.
+		task<std::size_t> async_read_some(const std::span<std::uint8_t> buffer) {
+			while (!engine_.plaintext_available()) {
+				if (engine_.closed())
+					co_return 0;
+				const bool __received = co_await fill_();
+				if (!__received)
+					co_return 0;
+			}
+			const auto __data = engine_.read(buffer.size());
+			std::ranges::copy(__data, buffer.begin());
+			co_return __data.size();
+		}
+
+		task<void> async_write(const byte_string_view data) {
+			engine_.write(data);
+			co_await flush_();
+		}
+
+		/// Sends close_notify and closes the socket; only closes the socket if no connection was established.
+		task<void> async_close() {
+			if (!transport_) {
+				socket_.close();
+				co_return;
+			}
+			engine_.close();
+			co_await flush_();
+			transport_.reset();
+			socket_.close();
+		}
+
+	private:
+		tcp::reactor& loop_;
+
+		tcp::client socket_;
+
+		std::optional<tcp::async_endpoint> transport_;
+
+		engine engine_;
+
+		task<void> flush_() {
+			if (engine_.want_write())
+				co_await transport_->async_write(engine_.take_output());
+		}
+
+		/// Feeds the next ciphertext received; false once the peer has closed the connection.
+		task<bool> fill_() {
+			std::uint8_t __buffer[1 << 14];
+			const auto __n = co_await transport_->async_read_some(__buffer);
+			if (!__n)
+				co_return false;
+			engine_.feed({__buffer, __n});
+			// the engine may have answered, e.g. with a key update
+			co_await flush_();
+			co_return true;
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,74 @@
+#pragma once
+#include "tls/cert/x509.h"
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace network::tls::x509 {
+
+	/**
+	 * \brief Chains that passed validation, keyed by a SHA-256 hash of the host name, leaf and intermediates.
+	 *
+	 * An entry expires at the earliest notAfter of its path, so a hit never outlives any certificate it vouches for.
+	 */
+	class chain_cache {
+
+		std::mutex mutex_;
+
+		std::map<byte_string, std::chrono::sys_seconds> entries_;
+
+		std::size_t capacity_;
+
+	public:
+		explicit chain_cache(std::size_t capacity = 1024);
+
+		static byte_string key(const std::vector<byte_string>& chain, std::string_view host);
+
+		bool contains(const byte_string& key, std::chrono::sys_seconds now);
+
+		void store(byte_string key, std::chrono::sys_seconds expiry);
+
+		void clear();
+
+		std::size_t size();
+	};
+
+	/// Trust anchors for validating server certificate chains; configure before sharing between threads.
+	class trust_store {
+
+		std::multimap<byte_string, certificate> anchors_;
+
+		chain_cache cache_;
+
+		[[nodiscard]] const certificate* find_anchor_(const certificate&) const;
+
+	public:
+		/// Bound on the number of certificates in a path, anchor excluded.
+		std::size_t max_depth = 8;
+
+		void add(certificate);
+
+		/// Adds every certificate in a PEM bundle.
+		void add_pem(std::string_view bundle);
+
+		[[nodiscard]] std::size_t size() const {
+			return anchors_.size();
+		}
+
+		/**
+		 * \brief Validates a chain in the order of the TLS Certificate message, leaf first.
+		 *
+		 * Builds a path from the leaf through the presented intermediates to an anchor, checking validity periods,
+		 * CA constraints, signatures, and, unless `host` is empty, that the leaf names `host`. Chains that verified
+		 * before are served from the cache without repeating signature checks.
+		 * \return The parsed leaf certificate.
+		 * \throw alert describing why the chain was rejected.
+		 */
+		certificate verify(const std::vector<byte_string>& chain, std::string_view host,
+		                   std::chrono::system_clock::time_point now = std::chrono::system_clock::now());
+
+		chain_cache& cache() {
+			return cache_;
+		}
+	};
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include "byte_string.h"
+#include "tls/util/type.h"
+#include <chrono>
+#include <list>
+#include <optional>
+#include <string>
+
+namespace network::tls::x509 {
+
+	/// Dotted object identifiers of the algorithms and extensions this module understands.
+	namespace oid {
+
+		constexpr std::string_view rsa_encryption = "1.2.840.113549.1.1.1";
+
+		constexpr std::string_view sha256_with_rsa = "1.2.840.113549.1.1.11";
+
+		constexpr std::string_view sha384_with_rsa = "1.2.840.113549.1.1.12";
+
+		constexpr std::string_view ec_public_key = "1.2.840.10045.2.1";
+
+		constexpr std::string_view ecdsa_with_sha256 = "1.2.840.10045.4.3.2";
+
+		constexpr std::string_view ecdsa_with_sha384 = "1.2.840.10045.4.3.3";
+
+		constexpr std::string_view prime256v1 = "1.2.840.10045.3.1.7";
+
+		constexpr std::string_view key_usage = "2.5.29.15";
+
+		constexpr std::string_view subject_alt_name = "2.5.29.17";
+
+		constexpr std::string_view basic_constraints = "2.5.29.19";
+	}
+
+	struct public_key_info {
+
+		std::string algorithm;
+
+		/// Named curve of EC keys; empty for other algorithms.
+		std::string parameters;
+
+		/// Contents of the subjectPublicKey bit string.
+		byte_string key;
+	};
+
+	/// Fields of a DER-encoded X.509 v3 certificate needed for path validation (RFC 5280).
+	class certificate {
+
+		std::size_t tbs_offset_ = 0, tbs_size_ = 0;
+
+	public:
+		byte_string encoding;
+
+		/// DER encodings of the issuer and subject names; names are compared octet-wise.
+		byte_string issuer, subject;
+
+		std::chrono::sys_seconds not_before, not_after;
+
+		public_key_info public_key;
+
+		std::string signature_algorithm;
+
+		byte_string signature;
+
+		bool ca = false;
+
+		std::optional<std::size_t> path_length;
+
+		/// Whether the key may sign certificates; true when no keyUsage extension is present.
+		bool key_cert_sign = true;
+
+		std::list<std::string> dns_names;
+
+		/// Parses `der`; throws `std::runtime_error` on malformed input.
+		explicit certificate(byte_string der);
+
+		/// The signed portion, i.e. the encoding of TBSCertificate.
+		[[nodiscard]] byte_string_view tbs() const {
+			return byte_string_view{encoding}.substr(tbs_offset_, tbs_size_);
+		}
+
+		/// Matches `host` against the dNSName entries, allowing a wildcard in the leftmost label.
+		[[nodiscard]] bool matches_host(std::string_view host) const;
+
+		/// Checks that `issuer_cert` signed this certificate.
+		[[nodiscard]] bool signed_by(const certificate& issuer_cert) const;
+	};
+
+	/**
+	 * \brief Verifies `signature` over `data` with the subject key of `signer`.
+	 * \param algorithm Dotted OID of the signature algorithm.
+	 * \throw std::runtime_error if the algorithm or key type is not supported.
+	 */
+	bool verify_signature(const public_key_info& signer, std::string_view algorithm, byte_string_view data,
+	                      byte_string_view signature);
+
+	/// Verifies a TLS signature, e.g. of CertificateVerify, with the subject key of `signer`.
+	bool verify_signature(const public_key_info& signer, signature_scheme_t scheme, byte_string_view data,
+	                      byte_string_view signature);
+
+	/// Whether `verify_signature` handles `scheme`; ECDSA is limited to P-256 keys.
+	bool supports(signature_scheme_t scheme);
+}
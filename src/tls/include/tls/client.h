@@ -2,10 +2,30 @@
 #include "tls/endpoint.h"
 #include "tls-record/handshake.h"
 #include "tls/key/manager.h"
+#include "tls/cert/trust_store.h"
 #include <optional>
+#include <mutex>
 
 namespace network::tls {
 
+	/// Remembers the key exchange group each server selected, so later ClientHellos carry exactly one matching share.
+	class group_cache {
+
+		std::mutex mutex_;
+
+		std::map<std::string, named_group_t, std::less<>> groups_;
+
+	public:
+		std::optional<named_group_t> find(std::string_view host);
+
+		void store(std::string_view host, named_group_t);
+
+		void erase(std::string_view host);
+
+		/// The cache shared by all clients in the process.
+		static group_cache& global();
+	};
+
 	class client final: public endpoint, public stream_client {
 
 		enum class client_state_t: std::uint8_t {
@@ -19,12 +39,33 @@ namespace network::tls {
 
 		std::set<named_group_t> available_groups_{};
 
+		/// Groups whose key shares are sent in the initial ClientHello; generated lazily.
+		std::set<named_group_t> share_groups_{};
+
+		std::string peer_host_;
+
 		std::set<cipher_suite_t> available_cipher_suites_{};
 
+		client_state_t client_state_ = client_state_t::wait_server_hello;
+
+		byte_string handshake_msgs_;
+
+		std::optional<x509::certificate> peer_certificate_;
+
 		std::unique_ptr<client_hello> gen_client_hello_() const;
 
 		void handshake_();
 
+		void start_handshake_();
+
+		[[nodiscard]] std::string_view peer_name_() const;
+
+		[[nodiscard]] bool handshake_done_() const;
+
+		void handle_handshake_record_(const record&);
+
+		friend class engine;
+
 	public:
 		std::optional<byte_string> init_session_id;
 
@@ -34,12 +75,28 @@ namespace network::tls {
 
 		std::list<std::string> alpn_protocols{};
 
+		/// Cache of server-selected groups; set to `nullptr` to always offer every group in `add_group()`.
+		group_cache* key_share_cache = &group_cache::global();
+
+		/// Anchors for validating the server certificate chain; `nullptr` accepts any certificate.
+		x509::trust_store* trust = nullptr;
+
 		explicit client(stream_client&, std::unique_ptr<random_source> = std::make_unique<mt19937_uniform>());
 
 		void connect(std::string_view host, tcp_port_t port) override;
 
 		std::size_t available() override;
 
+		/// Whether the session is not closed and its transport is alive.
+		[[nodiscard]] bool alive() const override {
+			return client_state_ != client_state_t::closed && client_.alive();
+		}
+
+		/// Leaf certificate of the server, available once validated during the handshake.
+		[[nodiscard]] const std::optional<x509::certificate>& peer_certificate() const {
+			return peer_certificate_;
+		}
+
 		void add_group(named_group_t, bool generate = true);
 
 		void add_cipher_suite(std::initializer_list<cipher_suite_t>);
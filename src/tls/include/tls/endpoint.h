@@ -5,6 +5,7 @@
 #include "tls-record/record.h"
 #include "cipher/cipher_suite.h"
 #include "cipher/traffic_secret_manager.h"
+#include "io_buffer.h"
 #include <memory>
 
 namespace network::tls {
@@ -13,6 +14,8 @@ namespace network::tls {
 	protected:
 		stream_endpoint& base_;
 
+		const endpoint_type endpoint_type_;
+
 		std::unique_ptr<key_exchange_manager> key_exchange_;
 
 		std::unique_ptr<cipher_suite> cipher_;
@@ -21,12 +24,35 @@ namespace network::tls {
 
 		const std::unique_ptr<random_source> random_;
 
-		string_stream app_data_;
+		io_buffer app_data_;
 
 		void send_(const record&);
 
 		void send_(content_type_t, bool encrypted, std::initializer_list<std::unique_ptr<message>>);
 
+		/// Processes a record received after the handshake (alerts, application data and post-handshake messages).
+		void handle_record_(record);
+
+		/// Writes a record to the transport, or hands its plaintext to the kernel once offloaded.
+		void transmit_(const record&);
+
+		bool offloaded_ = false;
+
+		/**
+		 * \brief Installs the current application traffic keys into the kernel TLS ULP (Linux kTLS).
+		 *
+		 * From then on the kernel seals and opens records, so `read()`/`write()` are plain socket I/O and the socket
+		 * may be used with `sendfile`. Returns `false`, leaving records in userspace, if the transport is not a TCP
+		 * socket, the cipher suite is not supported by kTLS or the kernel module is unavailable.
+		 */
+		bool offload_();
+
+		/// Receives one record (or a part of an application data record) decrypted by the kernel.
+		record kernel_extract_();
+
+		/// Sends plaintext of the given content type through the kernel.
+		void kernel_send_(content_type_t, byte_string_view);
+
 	public:
 		protocol_version_t endpoint_version = protocol_version_t::TLS1_3;
 
@@ -36,6 +62,9 @@ namespace network::tls {
 
 		byte_string pre_shared_key;
 
+		/// Whether to offload record protection to the kernel after the handshake; see `offload_()`.
+		bool kernel_offload = false;
+
 		endpoint(stream_endpoint&, endpoint_type, std::unique_ptr<random_source> = std::make_unique<::mt19937_uniform>());
 
 		[[nodiscard]] bool
@@ -47,10 +76,22 @@ namespace network::tls {
 
 		std::uint8_t read() override;
 
+		/// Returns buffered application data, receiving records only while none is buffered; 0 after close_notify.
+		std::size_t read_some(std::span<std::uint8_t>) override;
+
 		void write(std::uint8_t octet) override;
 
 		void write(byte_string_view) override;
 
+		/// Seals `buffers` into as few records as possible and hands them to the transport in one gather write.
+		void write(std::span<const byte_string_view>) override;
+
+		/// Lets the transport send the file directly once records are offloaded to the kernel; copies otherwise.
+		std::size_t send_file(int fd, std::uint64_t offset, std::size_t length) override;
+
+		/// Corks the transport, so records written meanwhile are coalesced into full segments.
+		void cork(bool) override;
+
 		void finish() override;
 
 		void close() override;
@@ -76,6 +117,12 @@ namespace network::tls {
 			return secret_;
 		}
 
+		/// Whether records are currently sealed and opened by the kernel.
+		[[nodiscard]] bool
+		offloaded() const {
+			return offloaded_;
+		}
+
 		bool compatibility_mode = false;
 	};
 }
@@ -0,0 +1,98 @@
+#pragma once
+#include "tls/client.h"
+
+namespace network::tls {
+
+	/**
+	 * \brief Sans-I/O driver of a TLS client session.
+	 *
+	 * The engine never touches a socket: ciphertext received from the peer is handed to `feed()`, and records to be
+	 * sent are collected from `take_output()`. Readiness is reported through `handshake_done()`, `want_read()`,
+	 * `want_write()` and `plaintext_available()`, so one thread can multiplex many sessions from a readiness loop.
+	 */
+	class engine final {
+
+		/// Transport given to the session; collects outgoing records and never blocks.
+		struct buffer_transport final: stream_client {
+
+			byte_string output;
+
+			bool opened = false, finished = false;
+
+			[[nodiscard]] bool connected() const override {
+				return opened;
+			}
+
+			void connect(std::string_view, tcp_port_t) override {
+				opened = true;
+				finished = false;
+			}
+
+			std::size_t available() override {
+				return 0;
+			}
+
+			std::uint8_t read() override {
+				throw std::logic_error("tls engine: transport must not be read; use feed()");
+			}
+
+			void write(const std::uint8_t octet) override {
+				output.push_back(octet);
+			}
+
+			void write(const byte_string_view data) override {
+				output.append(data);
+			}
+
+			void finish() override {
+				finished = true;
+			}
+
+			void close() override {
+				opened = false;
+			}
+		};
+
+		buffer_transport transport_;
+
+		client session_;
+
+		byte_string input_;
+
+	public:
+		explicit engine(std::unique_ptr<random_source> = std::make_unique<mt19937_uniform>());
+
+		/// The underlying session, used to configure groups, cipher suites, ALPN and server name before `start()`.
+		client& session() {
+			return session_;
+		}
+
+		/// Resets the session and queues a ClientHello.
+		void start();
+
+		/// Consumes ciphertext received from the peer; incomplete records are kept until more data arrives.
+		void feed(byte_string_view ciphertext);
+
+		/// Takes all bytes that should be sent to the peer.
+		byte_string take_output();
+
+		/// Encrypts application data into records queued for sending.
+		void write(byte_string_view plaintext);
+
+		/// Takes at most `max` bytes of decrypted application data.
+		byte_string read(std::size_t max);
+
+		/// Queues close_notify.
+		void close();
+
+		[[nodiscard]] bool handshake_done() const;
+
+		[[nodiscard]] bool closed() const;
+
+		[[nodiscard]] bool want_read() const;
+
+		[[nodiscard]] bool want_write() const;
+
+		[[nodiscard]] std::size_t plaintext_available() const;
+	};
+}
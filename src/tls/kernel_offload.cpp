@@ -0,0 +1,135 @@
+#include "tls/endpoint.h"
+#include "tcp/endpoint.h"
+
+#ifdef PLATFORM_Linux
+
+#include <linux/tls.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#endif
+
+namespace network::tls {
+
+#ifdef PLATFORM_Linux
+
+	namespace {
+
+		template<class Info>
+		void fill_crypto_info_(Info& info, const big_unsigned& key, const big_unsigned& iv, const std::uint64_t sequence) {
+			const auto __k = key.to_bytestring(std::endian::big), __iv = iv.to_bytestring(std::endian::big);
+			if (__k.size() != sizeof info.key || __iv.size() != sizeof info.salt + sizeof info.iv)
+				throw std::runtime_error{"[TLS endpoint] unexpected key or iv length"};
+			std::ranges::copy(__k, info.key);
+			std::ranges::copy(__iv.substr(0, sizeof info.salt), info.salt);
+			std::ranges::copy(__iv.substr(sizeof info.salt), info.iv);
+			for (std::size_t i = 0; i < sizeof info.rec_seq; ++i)
+				info.rec_seq[i] = sequence >> (sizeof info.rec_seq - 1 - i) * 8 & 0xff;
+		}
+
+		template<class Info>
+		bool install_(const socket_t socket, const std::uint16_t cipher_type, const int direction, const big_unsigned& key,
+				const big_unsigned& iv, const std::uint64_t sequence) {
+			Info info{};
+			info.info.version = TLS_1_3_VERSION;
+			info.info.cipher_type = cipher_type;
+			fill_crypto_info_(info, key, iv, sequence);
+			return !setsockopt(socket, SOL_TLS, direction, &info, sizeof info);
+		}
+	}
+
+	bool endpoint::offload_() {
+		if (offloaded_)
+			return true;
+		const auto __t = dynamic_cast<const tcp::endpoint*>(&base_);
+		if (!__t || !__t->connected() || !cipher_)
+			return false;
+		if (cipher_->value != cipher_suite_t::AES_128_GCM_SHA256 && cipher_->value != cipher_suite_t::AES_256_GCM_SHA384)
+			// checked before the ULP is attached, so the connection stays usable in userspace
+			return false;
+		const auto __s = __t->native_handle();
+		const bool __client = endpoint_type_ == endpoint_type::client;
+		auto& tx_key = __client ? secret_.client_write_key : secret_.server_write_key;
+		auto& tx_iv = __client ? secret_.client_write_iv : secret_.server_write_iv;
+		auto& rx_key = __client ? secret_.server_write_key : secret_.client_write_key;
+		auto& rx_iv = __client ? secret_.server_write_iv : secret_.client_write_iv;
+
+		if (setsockopt(__s, SOL_TCP, TCP_ULP, "tls", sizeof "tls"))
+			// tls module is not loaded, or the socket is not in a state that accepts ULP
+			return false;
+		const bool installed = cipher_->value == cipher_suite_t::AES_128_GCM_SHA256
+				? install_<tls12_crypto_info_aes_gcm_128>(__s, TLS_CIPHER_AES_GCM_128, TLS_TX, tx_key, tx_iv, secret_.write_nonce)
+						&& install_<tls12_crypto_info_aes_gcm_128>(__s, TLS_CIPHER_AES_GCM_128, TLS_RX, rx_key, rx_iv, secret_.read_nonce)
+				: install_<tls12_crypto_info_aes_gcm_256>(__s, TLS_CIPHER_AES_GCM_256, TLS_TX, tx_key, tx_iv, secret_.write_nonce)
+						&& install_<tls12_crypto_info_aes_gcm_256>(__s, TLS_CIPHER_AES_GCM_256, TLS_RX, rx_key, rx_iv, secret_.read_nonce);
+		if (!installed)
+			// the ULP can not be detached again; once it is attached, a half-installed state is unusable
+			throw std::runtime_error{std::format("[TLS endpoint] kernel rejected keys for {} (errno {})", cipher_->value, errno)};
+		offloaded_ = true;
+		return true;
+	}
+
+	record endpoint::kernel_extract_() {
+		const auto __s = dynamic_cast<const tcp::endpoint&>(base_).native_handle();
+		byte_string buffer(1 << 14, 0);
+		alignas(cmsghdr) char control[CMSG_SPACE(sizeof(std::uint8_t))];
+		iovec iov{buffer.data(), buffer.size()};
+		msghdr msg{};
+		msg.msg_iov = &iov;
+		msg.msg_iovlen = 1;
+		msg.msg_control = control;
+		msg.msg_controllen = sizeof control;
+		const auto count = recvmsg(__s, &msg, 0);
+		if (count < 0)
+			throw std::runtime_error{std::format("[TLS endpoint] recvmsg gives error {}", errno)};
+		if (count == 0) {
+			base_.close();
+			throw std::runtime_error("tcp closed");
+		}
+		buffer.resize(count);
+		auto type = content_type_t::application_data;
+		if (const auto cmsg = CMSG_FIRSTHDR(&msg); cmsg && cmsg->cmsg_level == SOL_TLS && cmsg->cmsg_type == TLS_GET_RECORD_TYPE)
+			type = static_cast<content_type_t>(*CMSG_DATA(cmsg));
+		record record{type, std::ref(secret_)};
+		record.messages = std::move(buffer);
+		return record;
+	}
+
+	void endpoint::kernel_send_(const content_type_t type, const byte_string_view data) {
+		if (type == content_type_t::application_data) {
+			base_.write(data);
+			return;
+		}
+		const auto __s = dynamic_cast<const tcp::endpoint&>(base_).native_handle();
+		alignas(cmsghdr) char control[CMSG_SPACE(sizeof(std::uint8_t))]{};
+		iovec iov{const_cast<std::uint8_t*>(data.data()), data.size()};
+		msghdr msg{};
+		msg.msg_iov = &iov;
+		msg.msg_iovlen = 1;
+		msg.msg_control = control;
+		msg.msg_controllen = sizeof control;
+		const auto cmsg = CMSG_FIRSTHDR(&msg);
+		cmsg->cmsg_level = SOL_TLS;
+		cmsg->cmsg_type = TLS_SET_RECORD_TYPE;
+		cmsg->cmsg_len = CMSG_LEN(sizeof(std::uint8_t));
+		*CMSG_DATA(cmsg) = static_cast<std::uint8_t>(type);
+		if (sendmsg(__s, &msg, 0) < 0)
+			throw std::runtime_error{std::format("[TLS endpoint] sendmsg gives error {}", errno)};
+	}
+
+#else
+
+	bool endpoint::offload_() {
+		return false;
+	}
+
+	record endpoint::kernel_extract_() {
+		throw std::logic_error{"kernel offload is not available on this platform"};
+	}
+
+	void endpoint::kernel_send_(content_type_t, byte_string_view) {
+		throw std::logic_error{"kernel offload is not available on this platform"};
+	}
+
+#endif
+}
@@ -55,6 +55,22 @@ namespace network::tls {
 		return {alert_level_t::fatal, alert_description_t::decrypt_error, __d};
 	}
 
+	alert alert::bad_certificate(const std::string_view __d) {
+		return {alert_level_t::fatal, alert_description_t::bad_certificate, __d};
+	}
+
+	alert alert::unsupported_certificate(const std::string_view __d) {
+		return {alert_level_t::fatal, alert_description_t::unsupported_certificate, __d};
+	}
+
+	alert alert::certificate_expired(const std::string_view __d) {
+		return {alert_level_t::fatal, alert_description_t::certificate_expired, __d};
+	}
+
+	alert alert::unknown_ca(const std::string_view __d) {
+		return {alert_level_t::fatal, alert_description_t::unknown_ca, __d};
+	}
+
 	alert alert::close_notify() {
 		return {alert_level_t::warning, alert_description_t::close_notify, ""};
 	}
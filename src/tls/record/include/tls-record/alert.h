@@ -33,6 +33,14 @@ namespace network::tls {
 		static alert illegal_parameter(std::string_view = "illegal parameter");
 
 		static alert decrypt_error(std::string_view = "decrypt error");
+
+		static alert bad_certificate(std::string_view = "bad certificate");
+
+		static alert unsupported_certificate(std::string_view = "unsupported certificate");
+
+		static alert certificate_expired(std::string_view = "certificate expired");
+
+		static alert unknown_ca(std::string_view = "unknown ca");
 	};
 
 }
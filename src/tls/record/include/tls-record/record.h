@@ -3,7 +3,10 @@
 #include "tls/util/type.h"
 #include "tls/cipher/traffic_secret_manager.h"
 #include <string>
+#include <optional>
 #include <format>
+#include <span>
+#include <vector>
 
 namespace network::tls {
 
@@ -37,8 +40,22 @@ namespace network::tls {
 
 		operator byte_string() const;
 
+		/// Protects and frames `messages` as records of at most 2^14 octets each, one string per record.
+		[[nodiscard]] std::vector<byte_string> seal() const;
+
+		/// As `seal()`, but takes the payload from `data`, which may be scattered over several buffers.
+		[[nodiscard]] std::vector<byte_string> seal(std::span<const byte_string_view> data) const;
+
 		static record extract(istream&, traffic_secret_manager& cipher);
 
+		/**
+		 * \brief Non-blocking counterpart of `extract()`.
+		 *
+		 * Takes one record from the front of `source` and advances it past that record. If `source` does not hold a
+		 * complete record yet, `std::nullopt` is returned and `source` is left untouched.
+		 */
+		static std::optional<record> parse(byte_string_view& source, traffic_secret_manager& cipher);
+
 		static record construct(content_type_t, opt_cipher, const message&);
 
 		bool encrypted() const {
@@ -47,6 +64,8 @@ namespace network::tls {
 
 	private:
 		opt_cipher cipher_;
+
+		static record decode_(byte_string_view header, byte_string fragment, traffic_secret_manager&);
 	};
 }
 
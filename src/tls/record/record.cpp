@@ -10,15 +10,34 @@ namespace network::tls {
 		: type(type), cipher_(cipher) {
 	}
 
+	constexpr std::size_t header_size = sizeof(content_type_t) + sizeof(protocol_version_t) + sizeof(std::uint16_t);
+
 	record record::extract(istream& __s, traffic_secret_manager& cipher) {
-		const auto header = __s.read(sizeof(content_type_t) + sizeof(protocol_version_t) + sizeof(std::uint16_t));
+		const auto header = __s.read(header_size);
+		auto it = std::next(header.begin(), sizeof(content_type_t) + sizeof(protocol_version_t));
+		const auto length = read<std::uint16_t>(std::endian::big, it);
+		return decode_(header, __s.read(length), cipher);
+	}
+
+	std::optional<record> record::parse(byte_string_view& source, traffic_secret_manager& cipher) {
+		if (source.size() < header_size)
+			return std::nullopt;
+		auto it = std::next(source.begin(), sizeof(content_type_t) + sizeof(protocol_version_t));
+		const auto length = read<std::uint16_t>(std::endian::big, it);
+		if (source.size() < header_size + length)
+			return std::nullopt;
+		const auto header = source.substr(0, header_size);
+		byte_string fragment{source.substr(header_size, length)};
+		source.remove_prefix(header_size + length);
+		return decode_(header, std::move(fragment), cipher);
+	}
+
+	record record::decode_(const byte_string_view header, byte_string fragment, traffic_secret_manager& cipher) {
 		auto it = header.begin();
 		auto type = read<content_type_t>(std::endian::big, it);
 		const auto version = read<protocol_version_t>(std::endian::big, it);
-		const auto length = read<std::uint16_t>(std::endian::big, it);
 		bool encrypted = false;
 
-		auto fragment = __s.read(length);
 		if (content_type_t::application_data == type) {
 			auto plain_fragment = cipher.decrypt(header, fragment);
 			const auto pos = plain_fragment.find_last_not_of(static_cast<std::uint8_t>(0));
@@ -43,23 +62,46 @@ namespace network::tls {
 
 	record::operator byte_string() const {
 		byte_string str;
-		for (auto it = messages.begin(), end = messages.end(); it != end; ) {
-			const std::uint16_t length = std::min<std::ptrdiff_t>(std::distance(it, end), 1 << 14);
+		for (const auto& record: seal())
+			str += record;
+		return str;
+	}
+
+	std::vector<byte_string> record::seal() const {
+		const byte_string_view __m{messages};
+		return seal({&__m, 1});
+	}
+
+	std::vector<byte_string> record::seal(const std::span<const byte_string_view> data) const {
+		std::vector<byte_string> sealed;
+		auto __buffer = data.begin();
+		std::size_t __offset = 0;
+		for (;;) {
+			byte_string plain_text;
+			while (plain_text.size() < 1 << 14 && __buffer != data.end()) {
+				const auto __n = std::min(__buffer->size() - __offset, (1 << 14) - plain_text.size());
+				plain_text.append(__buffer->substr(__offset, __n));
+				if ((__offset += __n) == __buffer->size()) {
+					++__buffer;
+					__offset = 0;
+				}
+			}
+			if (plain_text.empty())
+				break;
 			byte_string record;
+			record.reserve(header_size + plain_text.size() + (cipher_ ? 17 : 0));
 			write(std::endian::big, record, cipher_ ? content_type_t::application_data : type);
 			write(std::endian::big, record, version);
-			byte_string plain_text{it, std::next(it, length)};
 			if (cipher_) {
 				write(std::endian::big, plain_text, type);
 				write(std::endian::big, record, plain_text.size() + 16, 2);
 				record += cipher_.value().get().encrypt(record, plain_text);
 			} else {
-				write(std::endian::big, record, length, 2);
-				record.append(it, std::next(it, length));
+				write(std::endian::big, record, plain_text.size(), 2);
+				record += plain_text;
 			}
-			str += record;
-			std::advance(it, length);
+			sealed.push_back(std::move(record));
 		}
-		return str;
+		return sealed;
 	}
 }
@@ -0,0 +1,24 @@
+#include <gtest/gtest.h>
+#include "tcp/client.h"
+#include "tcp/server.h"
+#include <thread>
+
+using namespace network;
+
+TEST(alive, detects_peer_close) {
+	tcp::server __server;
+	__server.listen(0, 16);
+	tcp::client __c;
+	__c.connect("localhost", __server.local_port());
+	const auto __e = __server.accept();
+	auto& __accepted = dynamic_cast<tcp::endpoint&>(*__e);
+	EXPECT_TRUE(__accepted.alive());
+	// unread data does not count as closed
+	__c.write(reinterpret_cast<const std::uint8_t*>("ab"));
+	EXPECT_TRUE(__accepted.alive());
+	EXPECT_EQ(__e->read(2), reinterpret_cast<const std::uint8_t*>("ab"));
+	__c.close();
+	for (int i = 0; i < 100 && __accepted.alive(); ++i)
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	EXPECT_FALSE(__accepted.alive());
+}
@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+#include "tcp/async.h"
+
+using namespace network;
+
+namespace {
+
+	task<int> answer() {
+		co_return 42;
+	}
+
+	task<int> add_one() {
+		co_return co_await answer() + 1;
+	}
+
+	task<void> fail() {
+		throw std::runtime_error("expected");
+		co_return;
+	}
+
+	task<void> echo_once(tcp::reactor& loop, tcp::server& server) {
+		const auto __e = co_await tcp::async_accept(loop, server);
+		tcp::async_endpoint __ep{loop, *__e};
+		std::uint8_t __buffer[256];
+		while (const auto __n = co_await __ep.async_read_some(__buffer))
+			co_await __ep.async_write({__buffer, __n});
+	}
+
+	task<byte_string> ping(tcp::reactor& loop, const tcp_port_t port) {
+		tcp::client __c;
+		co_await tcp::async_connect(loop, __c, "localhost", port);
+		byte_string __echo;
+		{
+			tcp::async_endpoint __ep{loop, __c};
+			const byte_string __large(1 << 20, 'x');
+			co_await __ep.async_write(__large);
+			std::uint8_t __buffer[4096];
+			while (__echo.size() < __large.size())
+				__echo.append(__buffer, co_await __ep.async_read_some(__buffer));
+		}
+		__c.close();
+		co_return __echo;
+	}
+}
+
+TEST(task, chain) {
+	tcp::reactor __r;
+	EXPECT_EQ(tcp::block_on(__r, add_one()), 43);
+	EXPECT_THROW(tcp::block_on(__r, fail()), std::runtime_error);
+}
+
+TEST(task, echo) {
+	tcp::reactor __r;
+	tcp::server __server;
+	__server.listen(0, 16);
+	auto __echo = echo_once(__r, __server);
+	__echo.start();
+	const auto __received = tcp::block_on(__r, ping(__r, __server.local_port()));
+	EXPECT_EQ(__received.size(), 1 << 20);
+	EXPECT_EQ(__received.find_first_not_of('x'), byte_string::npos);
+	while (!__echo.done())
+		__r.run_once();
+	__echo.get();
+}
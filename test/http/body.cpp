@@ -0,0 +1,267 @@
+#include <gtest/gtest.h>
+#include "http1_1/client.h"
+#include "http1_1/common.h"
+#include "http1_1/server.h"
+#include "tcp/unix_socket.h"
+#include <thread>
+
+using namespace network;
+
+namespace {
+
+	struct body: testing::Test {
+
+		string_stream stream;
+
+		/// Small blocks, so bodies arrive over several reads.
+		buffered_stream buffer{stream, 8};
+
+		void write(const std::string_view s) {
+			stream.write(byte_string_view{reinterpret_cast<const std::uint8_t*>(s.data()), s.size()});
+		}
+
+		static http::fields with(const std::string_view name, const std::string_view value) {
+			http::fields __f;
+			__f.set(name, value);
+			return __f;
+		}
+
+		static std::string text(const byte_string_view v) {
+			return {reinterpret_cast<const char*>(v.data()), v.size()};
+		}
+	};
+}
+
+TEST_F(body, chunked_incrementally) {
+	write("5;ext=1\r\nhello\r\n0000c\r\n, streaming!\r\n0\r\nTrailer: x\r\n\r\nNEXT");
+	http::body_reader __b{buffer, with("Transfer-Encoding", "chunked"), http::message_type::response};
+	std::vector<std::string> __pieces;
+	while (true) {
+		const auto __v = __b.next(4);
+		ASSERT_TRUE(__v);
+		if (__v->empty())
+			break;
+		EXPECT_LE(__v->size(), 4);
+		__pieces.push_back(text(__v.value()));
+	}
+	EXPECT_TRUE(__b.done());
+	std::string __all;
+	for (const auto& __p: __pieces)
+		__all += __p;
+	EXPECT_EQ(__all, "hello, streaming!");
+	EXPECT_GT(__pieces.size(), 4);
+	// the next message is untouched
+	EXPECT_EQ(buffer.peek(4), reinterpret_cast<const std::uint8_t*>("NEXT"));
+}
+
+TEST_F(body, stop_and_discard) {
+	write("0123456789abcdefNEXT");
+	{
+		http::body_reader __b{buffer, with("Content-Length", "16"), http::message_type::request};
+		EXPECT_EQ(__b.remaining(), 16);
+		std::string __seen;
+		const auto __r = __b.read_all([&](const byte_string_view v) {
+			__seen += text(v);
+			return __seen.size() < 4;
+		});
+		ASSERT_TRUE(__r);
+		EXPECT_FALSE(__r.value());
+		EXPECT_FALSE(__b.done());
+		EXPECT_LT(__b.remaining(), 16);
+		EXPECT_TRUE(__b.discard());
+		EXPECT_TRUE(__b.done());
+	}
+	EXPECT_EQ(buffer.peek(4), reinterpret_cast<const std::uint8_t*>("NEXT"));
+}
+
+TEST_F(body, framing) {
+	write("abc");
+	http::body_reader __truncated{buffer, with("Content-Length", "5"), http::message_type::request};
+	std::uint8_t __data[8];
+	EXPECT_EQ(__truncated.read_some(__data).value(), 3);
+	EXPECT_EQ(__truncated.read_some(__data).error(), http::message_body_parse_error::content_truncated);
+
+	write("until close");
+	http::body_reader __until_close{buffer, {}, http::message_type::response};
+	std::string __r;
+	EXPECT_TRUE(__until_close.read_all([&](const byte_string_view v) {
+		__r += text(v);
+		return true;
+	}).value());
+	EXPECT_EQ(__r, "until close");
+
+	// requests without framing have no content
+	http::body_reader __none{buffer, {}, http::message_type::request};
+	EXPECT_TRUE(__none.next()->empty());
+	EXPECT_EQ(http::body_reader(buffer, with("Transfer-Encoding", "gzip"), http::message_type::request).next().error(),
+		http::message_body_parse_error::cannot_determine_length);
+	write("zz\r\n");
+	EXPECT_EQ(http::body_reader(buffer, with("Transfer-Encoding", "chunked"), http::message_type::request).next().error(),
+		http::message_body_parse_error::invalid_chunk_size);
+}
+
+TEST_F(body, chunked_truncated) {
+	// the stream ends within a chunk, before its CRLF, before the next chunk size, and within the trailers
+	for (const auto __m: {"5\r\nhel", "5\r\nhello", "5\r\nhello\r\n", "5\r\nhello\r\n0\r\nTrailer: x\r\n"}) {
+		write(__m);
+		http::body_reader __b{buffer, with("Transfer-Encoding", "chunked"), http::message_type::response};
+		EXPECT_EQ(__b.discard().error(), http::message_body_parse_error::content_truncated) << __m;
+		buffer.clear();
+	}
+	// cut short in either framing, a whole response body is returned as far as it arrived
+	write("5\r\nhello\r\n3\r\nab");
+	EXPECT_EQ(http::read_message_content(buffer, with("Transfer-Encoding", "chunked"), http::message_type::response),
+		"helloab");
+	write("abc");
+	EXPECT_EQ(http::read_message_content(buffer, with("Content-Length", "5"), http::message_type::response), "abc");
+	// while a request body cut short is an error
+	write("5\r\nhello\r\n3\r\nab");
+	EXPECT_EQ(http::read_message_content(buffer, with("Transfer-Encoding", "chunked"), http::message_type::request).error(),
+		http::message_body_parse_error::content_truncated);
+	buffer.clear();
+	write("abc");
+	EXPECT_EQ(http::read_message_content(buffer, with("Content-Length", "5"), http::message_type::request).error(),
+		http::message_body_parse_error::content_truncated);
+}
+
+TEST_F(body, malformed_lengths) {
+	// empty or overflowing lengths are errors rather than a shorter body
+	for (const auto __l: {"", "18446744073709551616", "99999999999999999999999", "+5", "-1"})
+		EXPECT_EQ(http::body_reader(buffer, with("Content-Length", __l), http::message_type::request).next().error(),
+			http::message_body_parse_error::invalid_content_length) << __l;
+	for (const auto __m: {"\r\n", ";ext\r\n", "10000000000000000\r\n"}) {
+		write(__m);
+		EXPECT_EQ(http::body_reader(buffer, with("Transfer-Encoding", "chunked"), http::message_type::request).next().error(),
+			http::message_body_parse_error::invalid_chunk_size) << __m;
+		buffer.clear();
+	}
+	// framing from a head parsed in place agrees with the fields built from it
+	http::request_head_view __head;
+	ASSERT_TRUE(__head.parse("POST / HTTP/1.1\r\nContent-Length: 5\r\ncontent-length: 5\r\n\r\n"));
+	EXPECT_EQ(http::body_reader(buffer, __head, http::message_type::request).next().error(),
+		http::message_body_parse_error::invalid_content_length);
+	EXPECT_EQ(http::body_reader(buffer, __head.to_fields(), http::message_type::request).next().error(),
+		http::message_body_parse_error::invalid_content_length);
+	// a chunk-size or trailer line is not buffered without bound
+	write("5;" + std::string(8192, 'x'));
+	EXPECT_EQ(http::body_reader(buffer, with("Transfer-Encoding", "chunked"), http::message_type::request).next().error(),
+		http::message_body_parse_error::invalid_chunk_line_folding);
+	buffer.clear();
+	write("0\r\nTrailer: " + std::string(8192, 'x'));
+	EXPECT_EQ(http::body_reader(buffer, with("Transfer-Encoding", "chunked"), http::message_type::request).next().error(),
+		http::message_body_parse_error::invalid_chunk_line_folding);
+}
+
+TEST_F(body, finished_flag) {
+	write("abcdeNEXT");
+	bool __finished = false;
+	http::body_reader __b{buffer, with("Content-Length", "5"), http::message_type::response, &__finished};
+	std::uint8_t __data[2];
+	EXPECT_EQ(__b.read_some(__data).value(), 2);
+	EXPECT_FALSE(__finished);
+	EXPECT_TRUE(__b.discard());
+	EXPECT_TRUE(__finished);
+}
+
+TEST_F(body, abandoned_over_connection) {
+	unix_socket::server __listener{"@network-test-body"};
+	http::server __server{__listener, false};
+	__server.listen(0, 4);
+	std::thread __t{[&] {
+		for (int i = 0; i < 2; ++i) {
+			// the client reconnects rather than read the next response after the rest of an abandoned one
+			const auto __e = __server.accept();
+			const auto __req = __e->fetch().value();
+			http::response __r{{}, static_cast<http::status>(200), std::string(100, 'x') + __req.target.path};
+			__r.headers.set("content-length", std::to_string(__r.content.size()));
+			__e->send(__r);
+			EXPECT_FALSE(__e->fetch());
+		}
+	}};
+	unix_socket::client __c{"@network-test-body"};
+	http::client __client{__c, false};
+	const auto __head = __client.fetch_head({"GET", uri::from("http://local.test/a")});
+	EXPECT_EQ(__head.headers.at("content-length"), "102");
+	const auto __r = __client.fetch({"GET", uri::from("http://local.test/b")});
+	EXPECT_EQ(__r.content, std::string(100, 'x') + "/b");
+	__c.close();
+	__t.join();
+}
+
+TEST_F(body, streamed_over_connection) {
+	unix_socket::server __listener{"@network-test-body"};
+	http::server __server{__listener, false};
+	__server.listen(0, 4);
+	const std::string __large(1 << 20, 'x');
+	std::thread __t{[&] {
+		const auto __e = __server.accept();
+		const auto __req = __e->fetch_head().value();
+		std::size_t __received = 0;
+		EXPECT_TRUE(__e->body(__req).read_all([&](const byte_string_view v) {
+			__received += v.size();
+			return true;
+		}).value());
+		EXPECT_EQ(__received, 5);
+		http::response __r{{}, static_cast<http::status>(200), __large};
+		__r.headers.set("content-length", std::to_string(__large.size()));
+		__e->send(__r);
+		EXPECT_FALSE(__e->fetch());
+	}};
+	unix_socket::client __c{"@network-test-body"};
+	http::client __client{__c, false};
+	http::request __req{"PUT", uri::from("http://local.test/upload")};
+	__req.content = "hello";
+	const auto __head = __client.fetch_head(__req);
+	EXPECT_EQ(static_cast<int>(__head.code), 200);
+	auto __b = __client.body(__head);
+	std::uint8_t __chunk[4096];
+	std::size_t __total = 0;
+	while (const auto __n = __b.read_some(__chunk).value()) {
+		EXPECT_LE(__n, sizeof __chunk);
+		__total += __n;
+	}
+	EXPECT_EQ(__total, __large.size());
+	__c.close();
+	__t.join();
+}
+
+TEST_F(body, head_views_over_connection) {
+	unix_socket::server __listener{"@network-test-body"};
+	http::server __server{__listener, false};
+	__server.listen(0, 4);
+	std::thread __t{[&] {
+		const auto __e = __server.accept();
+		for (const auto __path: {"/a", "/b"}) {
+			const auto __head = __e->fetch_head_view().value();
+			EXPECT_EQ(__head->method, "PUT");
+			EXPECT_EQ(__head->target, __path);
+			EXPECT_EQ(__head->field("Host"), "local.test");
+			std::string __content;
+			EXPECT_TRUE(__e->body(*__head).read_all([&](const byte_string_view v) {
+				__content += text(v);
+				return true;
+			}).value());
+			http::response __r{{}, static_cast<http::status>(200), __content + __path};
+			__r.headers.set("content-length", std::to_string(__r.content.size()));
+			__e->send(__r);
+		}
+		EXPECT_FALSE(__e->fetch());
+	}};
+	unix_socket::client __c{"@network-test-body"};
+	http::client __client{__c, false};
+	for (const auto __path: {"/a", "/b"}) {
+		http::request __req{"PUT", uri::from(std::string("http://local.test") + __path)};
+		__req.content = "hello";
+		const auto& __head = __client.fetch_head_view(__req);
+		EXPECT_EQ(static_cast<int>(__head.code), 200);
+		EXPECT_EQ(__head.field("content-length"), "7");
+		std::string __content;
+		EXPECT_TRUE(__client.body(__head).read_all([&](const byte_string_view v) {
+			__content += text(v);
+			return true;
+		}).value());
+		EXPECT_EQ(__content, std::string("hello") + __path);
+	}
+	__c.close();
+	__t.join();
+}
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include "http1_1/parser.h"
+#include <format>
+
+using namespace network::http;
+
+TEST(parser, request) {
+	constexpr std::string_view __m =
+		"GET /index.html?q=1 HTTP/1.1\r\n"
+		"Host: example.com\r\n"
+		"User-Agent: a rather long user agent string that spans several SIMD blocks/1.0\r\n"
+		"Accept:  text/html \r\n"
+		"accept: */*\r\n"
+		"\r\n"
+		"body";
+	request_head_view __h;
+	const auto __n = __h.parse(__m);
+	ASSERT_TRUE(__n);
+	EXPECT_EQ(__n.value(), __m.size() - 4);
+	EXPECT_EQ(__h.method, "GET");
+	EXPECT_EQ(__h.target, "/index.html?q=1");
+	EXPECT_EQ(__h.version, "HTTP/1.1");
+	ASSERT_EQ(__h.fields().size(), 4);
+	EXPECT_EQ(__h.fields()[1].value, "a rather long user agent string that spans several SIMD blocks/1.0");
+	EXPECT_EQ(__h.field("HOST"), "example.com");
+	EXPECT_EQ(__h.field("accept"), "text/html");
+	EXPECT_FALSE(__h.field("cookie"));
+	// the views point into the buffer
+	EXPECT_EQ(__h.method.data(), __m.data());
+
+	const auto __f = __h.to_fields();
+	EXPECT_EQ(__f.at("accept"), "text/html,*/*");
+	EXPECT_EQ(__f.at("user-agent"), __h.fields()[1].value);
+}
+
+TEST(parser, incomplete) {
+	constexpr std::string_view __m = "POST / HTTP/1.1\r\nContent-Length: 0\r\n\r\n";
+	request_head_view __h;
+	for (std::size_t i = 0; i < __m.size(); ++i)
+		EXPECT_EQ(__h.parse(__m.substr(0, i)).error(), head_parse_error::incomplete) << i;
+	EXPECT_EQ(__h.parse(__m).value(), __m.size());
+}
+
+TEST(parser, errors) {
+	request_head_view __h;
+	EXPECT_EQ(__h.parse("GET /\r\n\r\n").error(), head_parse_error::missing_space);
+	EXPECT_EQ(__h.parse("GET / HTTP/1.1\n\r\n").error(), head_parse_error::invalid_line_folding);
+	EXPECT_FALSE(__h.method.data());
+	EXPECT_EQ(__h.parse("GET / HTTP/1.1\r\na: b\rc\r\n\r\n").error(), head_parse_error::invalid_line_folding);
+	EXPECT_TRUE(__h.method.data());
+	EXPECT_EQ(__h.parse("GET / HTTP/1.1\r\n c: d\r\n\r\n").error(), head_parse_error::obsolete_line_folding);
+	EXPECT_EQ(__h.parse("GET / HTTP/1.1\r\nabc\r\n\r\n").error(), head_parse_error::missing_colon);
+	EXPECT_EQ(__h.parse("GET / HTTP/1.1\r\na : b\r\n\r\n").error(), head_parse_error::invalid_whitespace_after_name);
+	EXPECT_EQ(__h.parse("GET / HTTP/1.1\r\n: b\r\n\r\n").error(), head_parse_error::invalid_whitespace_after_name);
+}
+
+TEST(parser, many_fields) {
+	std::string __many = "GET / HTTP/1.1\r\n";
+	for (std::size_t i = 0; i < 3 * head_view::inline_fields; ++i)
+		__many += std::format("f{}: {}\r\n", i, i);
+	__many += "\r\n";
+	std::pmr::monotonic_buffer_resource __r;
+	request_head_view __h{&__r};
+	ASSERT_EQ(__h.parse(__many).value(), __many.size());
+	ASSERT_EQ(__h.fields().size(), 3 * head_view::inline_fields);
+	EXPECT_EQ(__h.fields()[0].name, "f0");
+	EXPECT_EQ(__h.field("f95"), "95");
+	// parsed again into the spilled storage, then back into the inline one
+	ASSERT_TRUE(__h.parse(__many));
+	EXPECT_EQ(__h.fields().size(), 3 * head_view::inline_fields);
+	ASSERT_TRUE(__h.parse("GET / HTTP/1.1\r\na: b\r\n\r\n"));
+	ASSERT_EQ(__h.fields().size(), 1);
+	EXPECT_EQ(__h.field("a"), "b");
+}
+
+TEST(parser, response) {
+	response_head_view __h;
+	ASSERT_TRUE(__h.parse("HTTP/1.1 404 Not Found\r\nContent-Length: 3\r\n\r\n"));
+	EXPECT_EQ(__h.version, "HTTP/1.1");
+	EXPECT_EQ(static_cast<int>(__h.code), 404);
+	EXPECT_EQ(__h.reason, "Not Found");
+	EXPECT_EQ(__h.field("content-length"), "3");
+	// the reason phrase may be empty or missing
+	ASSERT_TRUE(__h.parse("HTTP/1.1 200 \r\n\r\n"));
+	EXPECT_EQ(__h.reason, "");
+	ASSERT_TRUE(__h.parse("HTTP/1.1 204\r\n\r\n"));
+	EXPECT_EQ(__h.code, status::no_content);
+	EXPECT_EQ(__h.parse("HTTP/1.1 20x OK\r\n\r\n").error(), head_parse_error::invalid_status_code);
+	EXPECT_EQ(__h.parse("SPDY/3 200 OK\r\n\r\n").error(), head_parse_error::invalid_status_code);
+}
@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include "http1_1/client.h"
+#include "http1_1/server.h"
+#include "tcp/unix_socket.h"
+#include <thread>
+
+using namespace network;
+
+namespace {
+
+	struct pipeline: testing::Test {
+
+		unix_socket::server listener{"@network-test-pipeline"};
+
+		http::server server{listener, false};
+
+		unix_socket::client connection{"@network-test-pipeline"};
+
+		http::client client{connection, false};
+
+		void SetUp() override {
+			server.listen(0, 4);
+		}
+
+		static http::request get(const std::string_view path, const std::string_view method = "GET") {
+			return {std::string(method), uri::from(std::format("http://local.test{}", path))};
+		}
+
+		/// Sends the head of a response with 10 octets of content, but only 2 of them, and closes the connection.
+		static void truncated(http::serverside_endpoint& e) {
+			constexpr std::string_view __r = "HTTP/1.1 200 OK\r\ncontent-length: 10\r\n\r\n/a";
+			e.base().write(byte_string_view{reinterpret_cast<const std::uint8_t*>(__r.data()), __r.size()});
+			e.close();
+		}
+
+		static http::response ok(const http::request& r, const bool close = false) {
+			http::response __r{{}, static_cast<http::status>(200), r.target.path};
+			__r.headers.set("content-length", std::to_string(__r.content.size()));
+			if (close)
+				__r.headers.set("connection", "close");
+			return __r;
+		}
+	};
+}
+
+TEST_F(pipeline, back_to_back) {
+	std::thread __t{[this] {
+		const auto __e = server.accept();
+		// every request arrives before the first response is sent
+		std::vector<http::request> __requests;
+		for (int i = 0; i < 3; ++i)
+			__requests.push_back(__e->fetch().value());
+		for (const auto& __r: __requests)
+			__e->send(ok(__r));
+		EXPECT_FALSE(__e->fetch());
+	}};
+	auto __a = client.pipeline(get("/a")), __b = client.pipeline(get("/b")), __c = client.pipeline(get("/c"));
+	client.flush();
+	EXPECT_EQ(__a.get().content, "/a");
+	EXPECT_EQ(__b.get().content, "/b");
+	EXPECT_EQ(__c.get().content, "/c");
+	connection.close();
+	__t.join();
+	EXPECT_THROW(client.pipeline(get("/d", "POST")), std::invalid_argument);
+}
+
+TEST_F(pipeline, resent_after_close) {
+	std::thread __t{[this] {
+		{
+			// answers one request per connection
+			const auto __e = server.accept();
+			const auto __r = __e->fetch().value();
+			__e->send(ok(__r, true));
+			__e->close();
+		}
+		const auto __e = server.accept();
+		for (int i = 0; i < 2; ++i) {
+			const auto __r = __e->fetch().value();
+			__e->send(ok(__r));
+		}
+		EXPECT_FALSE(__e->fetch());
+	}};
+	auto __a = client.pipeline(get("/a")), __b = client.pipeline(get("/b")), __c = client.pipeline(get("/c", "HEAD"));
+	client.flush();
+	EXPECT_EQ(__a.get().content, "/a");
+	EXPECT_EQ(__b.get().content, "/b");
+	// a response to HEAD has no content, whatever Content-Length says
+	const auto __head = __c.get();
+	EXPECT_EQ(__head.headers.at("content-length"), "2");
+	EXPECT_EQ(__head.content, "");
+	connection.close();
+	__t.join();
+}
+
+TEST_F(pipeline, fails_after_one_retry) {
+	std::thread __t{[this] {
+		for (int i = 0; i < 2; ++i) {
+			const auto __e = server.accept();
+			__e->fetch();
+			__e->close();
+		}
+	}};
+	auto __a = client.pipeline(get("/a"));
+	client.flush();
+	EXPECT_THROW(__a.get(), http::client_error);
+	__t.join();
+}
+
+TEST_F(pipeline, resent_after_close_within_content) {
+	std::thread __t{[this] {
+		{
+			const auto __e = server.accept();
+			__e->fetch();
+			truncated(*__e);
+		}
+		const auto __e = server.accept();
+		const auto __r = __e->fetch().value();
+		__e->send(ok(__r));
+		EXPECT_FALSE(__e->fetch());
+	}};
+	auto __a = client.pipeline(get("/abcdefghi"));
+	client.flush();
+	EXPECT_EQ(__a.get().content, "/abcdefghi");
+	connection.close();
+	__t.join();
+}
+
+TEST_F(pipeline, fails_after_close_within_content_twice) {
+	std::thread __t{[this] {
+		for (int i = 0; i < 2; ++i) {
+			const auto __e = server.accept();
+			__e->fetch();
+			truncated(*__e);
+		}
+	}};
+	auto __a = client.pipeline(get("/a"));
+	client.flush();
+	EXPECT_THROW(__a.get(), http::client_error);
+	__t.join();
+}
@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include "http/pool.h"
+#include "tcp/unix_socket.h"
+#include <atomic>
+#include <thread>
+
+using namespace network;
+
+namespace {
+
+	struct fake_connection final: virtual string_stream, virtual stream_client {
+
+		http::origin destination;
+
+		bool open = true;
+
+		explicit fake_connection(http::origin o)
+			: destination(std::move(o)) {
+		}
+
+		[[nodiscard]] bool connected() const override {
+			return open;
+		}
+
+		void connect(std::string_view, tcp_port_t) override {
+		}
+
+		std::size_t available() override {
+			return size();
+		}
+
+		void finish() override {
+		}
+
+		void close() override {
+			open = false;
+		}
+	};
+
+	struct pool: testing::Test {
+
+		std::atomic<int> created = 0;
+
+		http::connection_pool::factory factory = [this](const http::origin& o) {
+			++created;
+			return std::make_unique<fake_connection>(o);
+		};
+
+		const http::origin a{"http", "a.test", 80}, b{"http", "b.test", 80};
+	};
+}
+
+TEST_F(pool, reuses_returned_connections) {
+	http::connection_pool __p{factory};
+	const stream_client* __first;
+	{
+		const auto __l = __p.acquire(a);
+		__first = &*__l;
+		EXPECT_EQ(__p.lent(a), 1);
+	}
+	EXPECT_EQ(__p.idle(a), 1);
+	const auto __l = __p.acquire(a);
+	EXPECT_EQ(&*__l, __first);
+	EXPECT_EQ(created, 1);
+}
+
+TEST_F(pool, alternating_origins) {
+	http::connection_pool __p{factory};
+	http::pooled_client __c{__p};
+	for (int i = 0; i < 3; ++i) {
+		__c.connect("a.test", 80);
+		__c.write(byte_string_view{reinterpret_cast<const std::uint8_t*>("x"), 1});
+		__c.connect("b.test", 80);
+	}
+	EXPECT_EQ(created, 2);
+	__c.connect("a.test", 80);
+	EXPECT_EQ(__c.read(3), reinterpret_cast<const std::uint8_t*>("xxx"));
+	// a discarded connection is not returned
+	__c.close();
+	EXPECT_EQ(__p.idle(a), 0);
+	EXPECT_EQ(__p.lent(a), 0);
+}
+
+TEST_F(pool, idle_timeout_and_health_check) {
+	http::connection_pool __expiring{factory, 6, std::chrono::seconds(0)};
+	__expiring.acquire(a);
+	__expiring.acquire(a);
+	EXPECT_EQ(created, 2);
+
+	bool __healthy = false;
+	http::connection_pool __checked{factory, 6, std::chrono::seconds(30), [&](stream_client&) { return __healthy; }};
+	__checked.acquire(a);
+	__checked.acquire(a);
+	EXPECT_EQ(created, 4);
+	__healthy = true;
+	__checked.acquire(a);
+	EXPECT_EQ(created, 4);
+}
+
+TEST_F(pool, max_per_origin) {
+	http::connection_pool __p{factory, 2};
+	auto __l1 = __p.acquire(a);
+	auto __l2 = __p.acquire(a);
+	// other origins are not limited by this one
+	__p.acquire(b);
+	std::atomic<bool> __acquired = false;
+	std::thread __t{[&] {
+		const auto __l3 = __p.acquire(a);
+		__acquired = true;
+	}};
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	EXPECT_FALSE(__acquired);
+	{
+		auto __released = std::move(__l1);
+	}
+	__t.join();
+	EXPECT_TRUE(__acquired);
+	EXPECT_EQ(created, 3);
+}
+
+TEST(pool_health, drops_connections_closed_by_the_peer) {
+	unix_socket::server __server{"@network-test-pool"};
+	__server.listen(0, 4);
+	int __created = 0;
+	http::connection_pool __p{[&](const http::origin&) {
+		++__created;
+		auto __c = std::make_unique<unix_socket::client>("@network-test-pool");
+		__c->connect("", 0);
+		return __c;
+	}};
+	const http::origin __o{"http", "local.test", 80};
+	__p.acquire(__o);
+	{
+		// the server closes the idle connection; the default check notices without reading
+		const auto __e = __server.accept();
+		__e->close();
+	}
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	const auto __l = __p.acquire(__o);
+	EXPECT_EQ(__created, 2);
+	EXPECT_TRUE(__l->alive());
+}
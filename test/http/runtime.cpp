@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include "http1_1/client.h"
+#include "http1_1/runtime.h"
+#include "tcp/unix_socket.h"
+
+using namespace network;
+
+namespace {
+
+	struct runtime: testing::Test {
+
+		unix_socket::server listener{"@network-test-runtime"};
+
+		http::server server{listener, false};
+
+		std::atomic<int> handled = 0;
+
+		/// Lets a request for /slow return.
+		std::atomic<bool> release = false;
+
+		http::server_runtime loop{server, [this](const http::request& r) {
+			++handled;
+			if (r.target.path == "/fail")
+				throw std::runtime_error("handler failed");
+			while (r.target.path == "/slow" && !release)
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			return http::response{{}, static_cast<http::status>(200), r.target.path};
+		}, 2};
+
+		std::thread acceptor;
+
+		void SetUp() override {
+			server.listen(0, 16);
+			acceptor = std::thread{[this] {
+				loop.run();
+			}};
+		}
+
+		void TearDown() override {
+			loop.stop();
+			acceptor.join();
+		}
+	};
+}
+
+TEST_F(runtime, keep_alive) {
+	std::vector<std::thread> __clients;
+	for (int i = 0; i < 2; ++i)
+		__clients.emplace_back([i] {
+			unix_socket::client __c{"@network-test-runtime"};
+			http::client __h{__c, false};
+			for (int j = 0; j < 5; ++j) {
+				const auto __path = std::format("/{}/{}", i, j);
+				EXPECT_EQ(__h.fetch({"GET", uri::from("http://local.test" + __path)}).content, __path);
+			}
+			__c.close();
+		});
+	for (auto& __t: __clients)
+		__t.join();
+	EXPECT_EQ(handled, 10);
+}
+
+TEST_F(runtime, errors_and_close) {
+	unix_socket::client __c{"@network-test-runtime"};
+	http::client __h{__c, false};
+	EXPECT_EQ(__h.fetch({"GET", uri::from("http://local.test/fail")}).code, http::status::internal_error);
+	http::request __last{"GET", uri::from("http://local.test/last")};
+	__last.headers.set("connection", "close");
+	const auto __r = __h.fetch(__last);
+	EXPECT_EQ(__r.content, "/last");
+	EXPECT_EQ(__r.headers.at("connection"), "close");
+	// the server ends the connection after answering
+	for (int i = 0; i < 100 && loop.connections(); ++i)
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	EXPECT_EQ(loop.connections(), 0);
+	__c.close();
+}
+
+TEST_F(runtime, stop_ends_idle_connections) {
+	unix_socket::client __c{"@network-test-runtime"};
+	http::client __h{__c, false};
+	EXPECT_EQ(__h.fetch({"GET", uri::from("http://local.test/x")}).content, "/x");
+	std::thread __closer{[&] {
+		// a client notices the shutdown on its next read and closes
+		std::uint8_t __b;
+		EXPECT_EQ(__c.read_some({&__b, 1}), 0);
+		__c.close();
+	}};
+	loop.stop();
+	EXPECT_EQ(loop.connections(), 0);
+	__closer.join();
+}
+
+TEST_F(runtime, idle_connections_do_not_hold_workers) {
+	// more idle keep-alive connections than workers
+	std::vector<std::unique_ptr<unix_socket::client>> __idle;
+	for (int i = 0; i < 4; ++i) {
+		auto& __c = __idle.emplace_back(std::make_unique<unix_socket::client>("@network-test-runtime"));
+		http::client __h{*__c, false};
+		EXPECT_EQ(__h.fetch({"GET", uri::from("http://local.test/idle")}).content, "/idle");
+	}
+	unix_socket::client __c{"@network-test-runtime"};
+	http::client __h{__c, false};
+	EXPECT_EQ(__h.fetch({"GET", uri::from("http://local.test/new")}).content, "/new");
+	EXPECT_EQ(loop.connections(), 5);
+	__c.close();
+	for (const auto& __i: __idle)
+		__i->close();
+}
+
+TEST_F(runtime, stop_answers_request_in_flight) {
+	unix_socket::client __idle{"@network-test-runtime"};
+	http::client __idle_h{__idle, false};
+	EXPECT_EQ(__idle_h.fetch({"GET", uri::from("http://local.test/x")}).content, "/x");
+
+	unix_socket::client __c{"@network-test-runtime"};
+	http::client __h{__c, false};
+	std::thread __client{[&] {
+		const auto __r = __h.fetch({"GET", uri::from("http://local.test/slow")});
+		EXPECT_EQ(__r.content, "/slow");
+		EXPECT_EQ(__r.headers.at("connection"), "close");
+	}};
+	while (handled < 2)
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	std::thread __stopper{[&] {
+		loop.stop();
+	}};
+	// the idle connection ends without waiting for its client, the busy one once answered
+	for (int i = 0; i < 1000 && loop.connections() > 1; ++i)
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	EXPECT_EQ(loop.connections(), 1);
+	release = true;
+	__stopper.join();
+	__client.join();
+	EXPECT_EQ(loop.connections(), 0);
+	__c.close();
+	__idle.close();
+}
@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 #include "http1_1/server.h"
+#include "arena.h"
+#include <cstdio>
 
 struct testing_stream final: virtual string_stream, virtual network::stream_endpoint {
 
@@ -100,3 +102,104 @@ TEST_F(server_semantics, invalid_request_line) {
 	));
 	EXPECT_EQ(server.fetch().error(), network::http::request_parse_error::request_line_missing_space);
 }
+
+TEST_F(server_semantics, header_fields_too_large) {
+	const std::string __head = "GET / HTTP/1.1\r\nCookie: " + std::string(200, 'x') + "\r\n";
+	stream().write(reinterpret_cast<const std::uint8_t*>(__head.c_str()));
+	server.max_head_size = 128;
+	const auto __r = server.fetch();
+	server.max_head_size = 64 * 1024;
+	EXPECT_EQ(__r.error(), network::http::request_parse_error::header_fields_too_large);
+	EXPECT_TRUE(std::string_view(reinterpret_cast<const char*>(stream().data()), stream().size()).contains("HTTP/1.1 431"));
+}
+
+TEST_F(fields_semantics, head_read_in_pieces) {
+	const std::string __m = "GET / HTTP/1.1\r\nHost: example.com\r\nAccept: */*\r\n\r\nbody";
+	stream.write(reinterpret_cast<const std::uint8_t*>(__m.c_str()));
+	// a few octets per read, so the empty line arrives split across reads
+	buffered_stream __b{stream, 3};
+	network::http::request_head_view __h;
+	const auto __n = network::http::read_head(__b, __h, 1024);
+	ASSERT_TRUE(__n);
+	EXPECT_EQ(__n.value(), __m.size() - 4);
+	EXPECT_EQ(__h.field("accept"), "*/*");
+	__b.consume(__n.value());
+	EXPECT_EQ(__b.peek(4), reinterpret_cast<const std::uint8_t*>("body"));
+}
+
+TEST_F(fields_semantics, head_read_bounded) {
+	stream.write(reinterpret_cast<const std::uint8_t*>("GET / HTTP/1.1\r\nHost: example.com\r\n\r\n"));
+	buffered_stream __b{stream, 4};
+	network::http::request_head_view __h;
+	EXPECT_EQ(network::http::read_head(__b, __h, 16).error(), network::http::head_parse_error::head_too_large);
+	EXPECT_LE(__b.buffered(), 20);
+}
+
+TEST_F(fields_semantics, head_read_truncated) {
+	stream.write(reinterpret_cast<const std::uint8_t*>("GET / HTTP/1.1\r\nHost: exa"));
+	buffered_stream __b{stream, 4};
+	network::http::request_head_view __h;
+	EXPECT_EQ(network::http::read_head(__b, __h, 1024).error(), network::http::head_parse_error::incomplete);
+}
+
+TEST_F(fields_semantics, buffered_headers) {
+	stream.write(reinterpret_cast<const std::uint8_t*>(
+		"Accept:  text/html \r\n"
+		"User-Agent: test\r\n"
+		"accept: */*\r\n"
+		"\r\n"
+		"body"
+	));
+	buffered_stream __b{stream};
+	const auto __f = network::http::fields::from_http_headers(__b);
+	ASSERT_TRUE(__f);
+	EXPECT_EQ(__f->at("user-agent"), "test");
+	EXPECT_EQ(__f->at("accept"), "text/html,*/*");
+	EXPECT_EQ(__b.peek(4), reinterpret_cast<const std::uint8_t*>("body"));
+}
+
+TEST_F(fields_semantics, buffered_bare_carriage_return) {
+	stream.write(reinterpret_cast<const std::uint8_t*>(
+		"a: b\rc\r\n"
+		"\r\n"
+	));
+	buffered_stream __b{stream};
+	EXPECT_EQ(
+		network::http::fields::from_http_headers(__b).error(),
+		network::http::field_parse_error::invalid_line_folding);
+}
+
+TEST_F(fields_semantics, buffered_short_read) {
+	stream.write(reinterpret_cast<const std::uint8_t*>("abc"));
+	buffered_stream __b{stream};
+	EXPECT_THROW(__b.read(4), std::runtime_error);
+	EXPECT_THROW(__b.skip(4), std::runtime_error);
+	EXPECT_EQ(__b.read(3), reinterpret_cast<const std::uint8_t*>("abc"));
+}
+
+TEST_F(fields_semantics, arena_allocated) {
+	stream.write(reinterpret_cast<const std::uint8_t*>(
+		"Accept: */*\r\nUser-Agent: a value too long for the small string buffer\r\n\r\n"));
+	arena __a;
+	buffered_stream __b{stream};
+	const auto __f = network::http::fields::from_http_headers(__b, &__a);
+	ASSERT_TRUE(__f);
+	EXPECT_EQ(__f->get_allocator().resource(), &__a);
+	// names and values too, not only the nodes
+	for (const auto& [__name, __value]: __f.value()) {
+		EXPECT_EQ(__name.get_allocator().resource(), &__a);
+		EXPECT_EQ(__value.get_allocator().resource(), &__a);
+	}
+	const network::http::fields __copy = __f.value();
+	EXPECT_EQ(__copy.get_allocator().resource(), std::pmr::get_default_resource());
+	EXPECT_EQ(__copy, __f.value());
+}
+
+TEST_F(server_semantics, send_file) {
+	const auto __file = std::tmpfile();
+	std::fputs("0123456789", __file);
+	std::fflush(__file);
+	server.send_file({{}, static_cast<network::http::status>(200)}, fileno(__file), 2, 5);
+	std::fclose(__file);
+	EXPECT_EQ(stream(), reinterpret_cast<const std::uint8_t*>("HTTP/1.1 200 \r\ncontent-length: 5\r\n\r\n23456"));
+}
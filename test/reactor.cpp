@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include "tcp/client.h"
+#include "tcp/server.h"
+#include "tcp/reactor.h"
+#include <thread>
+
+using namespace network;
+
+TEST(reactor, echo) {
+	tcp::reactor __r;
+	tcp::server __server;
+	__server.listen(0, 16);
+	__server.non_blocking(true);
+
+	std::vector<std::unique_ptr<tcp::endpoint>> __accepted;
+	__r.add(__server.native_handle(), EPOLLIN, [&](std::uint32_t) {
+		while (auto __e = __server.try_accept()) {
+			auto& __ep = *__accepted.emplace_back(std::move(__e));
+			__r.add(__ep.native_handle(), EPOLLIN, [&__r, &__ep](std::uint32_t) {
+				std::uint8_t __buffer[256];
+				while (const auto __n = __ep.try_read_some(__buffer)) {
+					if (!__n.value()) {
+						__r.remove(__ep.native_handle());
+						return;
+					}
+					__ep.try_write({__buffer, __n.value()});
+				}
+			});
+		}
+	});
+
+	tcp::client __c;
+	bool __connected = __c.begin_connect("localhost", __server.local_port());
+	if (!__connected)
+		__r.add(__c.native_handle(), EPOLLOUT, [&](std::uint32_t) {
+			__c.complete_connect();
+			__connected = true;
+			__r.remove(__c.native_handle());
+		});
+	while (!__connected || __accepted.empty())
+		__r.run_once(1000);
+	ASSERT_EQ(__accepted.size(), 1);
+
+	__c.write(reinterpret_cast<const std::uint8_t*>("ping"));
+	byte_string __echo;
+	__r.add(__c.native_handle(), EPOLLIN, [&](std::uint32_t) {
+		std::uint8_t __buffer[16];
+		for (auto __n = __c.try_read_some(__buffer); __n && __n.value(); __n = __c.try_read_some(__buffer))
+			__echo.append(__buffer, __n.value());
+	});
+	while (__echo.size() < 4)
+		__r.run_once(1000);
+	EXPECT_EQ(__echo, reinterpret_cast<const std::uint8_t*>("ping"));
+}
+
+TEST(reactor, post_from_other_thread) {
+	tcp::reactor __r;
+	int __value = 0;
+	std::thread __t{[&] {
+		__r.post([&] { __value = 42; });
+		__r.stop();
+	}};
+	__r.run();
+	__t.join();
+	EXPECT_EQ(__value, 42);
+}
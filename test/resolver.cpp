@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include "tcp/async.h"
+#include <thread>
+
+using namespace network;
+
+namespace {
+
+	task<std::size_t> count_addresses(tcp::reactor& loop, tcp::resolver& dns) {
+		const auto __r = co_await tcp::resolution{loop, dns, "localhost"};
+		co_return __r->size();
+	}
+}
+
+TEST(resolver, coalesces_and_caches) {
+	tcp::resolver __dns;
+	std::vector<tcp::resolver::result> __results(8);
+	std::vector<std::thread> __threads;
+	for (auto& __r: __results)
+		__threads.emplace_back([&] {
+			__r = __dns.resolve("localhost");
+		});
+	for (auto& __t: __threads)
+		__t.join();
+	EXPECT_EQ(__dns.lookups(), 1);
+	for (const auto& __r: __results) {
+		ASSERT_FALSE(__r->empty());
+		EXPECT_EQ(__r, __results.front());
+	}
+	EXPECT_TRUE(__dns.cached("localhost"));
+}
+
+TEST(resolver, threads_on_demand) {
+	tcp::resolver __dns{AF_INET, std::chrono::seconds(60), std::chrono::seconds(60), 16, 2};
+	EXPECT_EQ(__dns.threads(), 0);
+	for (const auto __name: {"a.invalid", "b.invalid", "c.invalid", "d.invalid"})
+		__dns.resolve(__name);
+	EXPECT_GE(__dns.threads(), 1);
+	EXPECT_LE(__dns.threads(), 2);
+}
+
+TEST(resolver, negative_and_expired) {
+	tcp::resolver __dns{AF_INET, std::chrono::seconds(0), std::chrono::seconds(60)};
+	EXPECT_TRUE(__dns.resolve("nonexistent.invalid")->empty());
+	EXPECT_TRUE(__dns.resolve("nonexistent.invalid")->empty());
+	EXPECT_EQ(__dns.lookups(), 1);
+	// positive results expire at once here
+	__dns.resolve("localhost");
+	__dns.resolve("localhost");
+	EXPECT_EQ(__dns.lookups(), 3);
+}
+
+TEST(resolver, bounded_cache) {
+	tcp::resolver __dns{AF_INET, std::chrono::seconds(60), std::chrono::seconds(60), 2, 1};
+	__dns.resolve("a.invalid");
+	__dns.resolve("b.invalid");
+	__dns.resolve("c.invalid");
+	EXPECT_EQ(__dns.size(), 2);
+	// the result expiring first made room
+	EXPECT_FALSE(__dns.cached("a.invalid"));
+	EXPECT_TRUE(__dns.cached("c.invalid"));
+
+	// expired results are dropped before anything else
+	tcp::resolver __expiring{AF_INET, std::chrono::seconds(0), std::chrono::seconds(60), 2, 1};
+	__expiring.resolve("localhost");
+	__expiring.resolve("a.invalid");
+	__expiring.resolve("b.invalid");
+	EXPECT_TRUE(__expiring.cached("a.invalid"));
+	EXPECT_TRUE(__expiring.cached("b.invalid"));
+}
+
+TEST(resolver, from_event_loop) {
+	tcp::reactor __r;
+	tcp::resolver __dns;
+	EXPECT_GT(tcp::block_on(__r, count_addresses(__r, __dns)), 0);
+	// served from the cache without suspending
+	EXPECT_GT(tcp::block_on(__r, count_addresses(__r, __dns)), 0);
+	EXPECT_EQ(__dns.lookups(), 1);
+}
+
+TEST(resolver, happy_eyeballs) {
+	tcp::server __server;
+	__server.listen(0, 16);
+	const auto __port = __server.local_port();
+
+	// an IPv6-only decoy on the same port whose accept queue is full, so further SYNs go unanswered
+	const socket_t __decoy = socket(AF_INET6, SOCK_STREAM, IPPROTO_TCP);
+	const int __on = 1;
+	setsockopt(__decoy, IPPROTO_IPV6, IPV6_V6ONLY, &__on, sizeof __on);
+	tcp::resolver __dns;
+	const auto __loopback6 = __dns.resolve("::1")->front().with_port(__port);
+	ASSERT_EQ(bind(__decoy, __loopback6.get(), __loopback6.length), 0);
+	ASSERT_EQ(::listen(__decoy, 0), 0);
+	tcp::client __queued;
+	__queued.connect(std::vector{__loopback6}, __port);
+
+	const std::vector __addresses{__loopback6, __dns.resolve("127.0.0.1")->front()};
+	tcp::client __c;
+	__c.attempt_delay = std::chrono::milliseconds(50);
+	const auto __start = std::chrono::steady_clock::now();
+	__c.connect(__addresses, __port);
+	const auto __elapsed = std::chrono::steady_clock::now() - __start;
+	EXPECT_GE(__elapsed, std::chrono::milliseconds(40));
+	EXPECT_LT(__elapsed, std::chrono::seconds(2));
+	const auto __e = __server.accept();
+	__c.write(reinterpret_cast<const std::uint8_t*>("v4"));
+	EXPECT_EQ(__e->read(2), reinterpret_cast<const std::uint8_t*>("v4"));
+	__c.close();
+	__queued.close();
+	::close(__decoy);
+}
+
+TEST(resolver, dual_stack_server) {
+	tcp::server __server;
+	__server.family = AF_INET6;
+	__server.listen(0, 16);
+	tcp::client __c6, __c4;
+	__c6.connect("::1", __server.local_port());
+	__c4.connect("127.0.0.1", __server.local_port());
+	const auto __e6 = __server.accept(), __e4 = __server.accept();
+	__c6.write(6);
+	__c4.write(4);
+	EXPECT_EQ(__e6->read() + __e4->read(), 10);
+	// clients close first so that the server's port is not left in TIME_WAIT
+	__c6.close();
+	__c4.close();
+}
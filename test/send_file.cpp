@@ -0,0 +1,34 @@
+#include <gtest/gtest.h>
+#include "tcp/client.h"
+#include "tcp/server.h"
+#include <cstdio>
+#include <thread>
+
+using namespace network;
+
+TEST(send_file, file_and_pipe) {
+	const auto __file = std::tmpfile();
+	const byte_string __content(1 << 20, 'f');
+	std::fwrite(__content.data(), 1, __content.size(), __file);
+	std::fflush(__file);
+	int __pipe[2];
+	ASSERT_EQ(pipe(__pipe), 0);
+	ASSERT_EQ(::write(__pipe[1], "piped", 5), 5);
+
+	tcp::server __server;
+	__server.listen(0, 16);
+	tcp::client __c;
+	__c.connect("localhost", __server.local_port());
+	const auto __e = __server.accept();
+	std::thread __t{[&] {
+		EXPECT_EQ(__c.send_file(fileno(__file), 16, __content.size() - 16), __content.size() - 16);
+		EXPECT_EQ(__c.send_file(__pipe[0], 0, 5), 5);
+	}};
+	EXPECT_EQ(__e->read(__content.size() - 16), __content.substr(16));
+	EXPECT_EQ(__e->read(5), reinterpret_cast<const std::uint8_t*>("piped"));
+	__t.join();
+	__c.close();
+	std::fclose(__file);
+	::close(__pipe[0]);
+	::close(__pipe[1]);
+}
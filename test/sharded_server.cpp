@@ -0,0 +1,31 @@
+#include <gtest/gtest.h>
+#include "tcp/client.h"
+#include "tcp/sharded_server.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+using namespace network;
+
+TEST(sharded_server, accepts) {
+	std::atomic<int> __accepted = 0;
+	std::mutex __m;
+	std::vector<std::unique_ptr<tcp::endpoint>> __connections;
+	tcp::sharded_server __s{3};
+	__s.listen(0, 16, [&](std::unique_ptr<tcp::endpoint> __e, tcp::reactor&) {
+		std::lock_guard __l{__m};
+		__connections.push_back(std::move(__e));
+		++__accepted;
+	});
+	ASSERT_NE(__s.local_port(), 0);
+
+	std::vector<tcp::client> __clients(8);
+	for (auto& __c: __clients)
+		__c.connect("localhost", __s.local_port());
+	for (int i = 0; i < 1000 && __accepted < 8; ++i)
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	__s.stop();
+	EXPECT_EQ(__accepted, 8);
+	for (auto& __c: __clients)
+		__c.close();
+}
@@ -0,0 +1,33 @@
+#include <gtest/gtest.h>
+#include "tcp/client.h"
+#include "tcp/server.h"
+#include <netinet/tcp.h>
+
+using namespace network;
+
+TEST(socket_options, applied_and_cork) {
+	const auto option = [](const socket_t __s, const int __level, const int __name) {
+		int __v = 0;
+		socklen_t __size = sizeof __v;
+		getsockopt(__s, __level, __name, &__v, &__size);
+		return __v;
+	};
+	tcp::server __server;
+	__server.options.no_delay = true;
+	__server.listen(0, 16);
+	tcp::client __c;
+	__c.options.keepalive = {.idle = 30, .interval = 5, .count = 3};
+	__c.connect("localhost", __server.local_port());
+	const auto __e = __server.accept();
+	const auto __s = dynamic_cast<tcp::endpoint&>(*__e).native_handle();
+	EXPECT_TRUE(option(__s, IPPROTO_TCP, TCP_NODELAY));
+	EXPECT_TRUE(option(__c.native_handle(), SOL_SOCKET, SO_KEEPALIVE));
+	EXPECT_EQ(option(__c.native_handle(), IPPROTO_TCP, TCP_KEEPIDLE), 30);
+
+	__c.cork(true);
+	EXPECT_TRUE(option(__c.native_handle(), IPPROTO_TCP, TCP_CORK));
+	__c.write(reinterpret_cast<const std::uint8_t*>("ab"));
+	__c.cork(false);
+	EXPECT_EQ(__e->read(2), reinterpret_cast<const std::uint8_t*>("ab"));
+	__c.close();
+}
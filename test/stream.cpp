@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+#include "io_buffer.h"
+#include "arena.h"
+#include <vector>
+
+TEST(io_buffer, chunks) {
+	io_buffer __b{4};
+	__b.append(byte_string_view{reinterpret_cast<const std::uint8_t*>("abcdefghij"), 10});
+	EXPECT_EQ(__b.size(), 10);
+	EXPECT_EQ(__b.front().size(), 10);
+	EXPECT_EQ(__b.read(), 'a');
+	EXPECT_EQ(__b.read(3), reinterpret_cast<const std::uint8_t*>("bcd"));
+	__b.append(byte_string{'k', 'l'});
+	__b.write(byte_string_view{reinterpret_cast<const std::uint8_t*>("mnop"), 4});
+	EXPECT_EQ(__b.size(), 12);
+	__b.skip(5);
+	EXPECT_EQ(__b.front(), reinterpret_cast<const std::uint8_t*>("j"));
+	std::uint8_t __out[8];
+	EXPECT_EQ(__b.read_some(__out), 7);
+	EXPECT_EQ((byte_string_view{__out, 7}), reinterpret_cast<const std::uint8_t*>("jklmnop"));
+	EXPECT_TRUE(__b.empty());
+	EXPECT_THROW(__b.read(), std::runtime_error);
+}
+
+TEST(io_buffer, read_exact) {
+	io_buffer __b;
+	__b.append(byte_string{1, 2, 3});
+	std::uint8_t __out[4];
+	EXPECT_THROW(__b.read_exact(__out), std::runtime_error);
+	EXPECT_EQ(__b.size(), 3);
+	__b.write(4);
+	__b.read_exact(__out);
+	EXPECT_EQ((byte_string{__out, 4}), (byte_string{1, 2, 3, 4}));
+	EXPECT_THROW(__b.consume(1), std::out_of_range);
+}
+
+TEST(arena, grows_on_reset) {
+	arena __a{256};
+	{
+		std::pmr::vector<std::uint64_t> __v{&__a};
+		__v.reserve(16);
+		EXPECT_EQ(__a.capacity(), 256);
+		__v.reserve(64);
+	}
+	__a.reset();
+	EXPECT_GT(__a.capacity(), 256 + 64 * sizeof(std::uint64_t));
+	const auto __capacity = __a.capacity();
+	{
+		std::pmr::vector<std::uint64_t> __v{&__a};
+		__v.reserve(64);
+	}
+	__a.reset();
+	EXPECT_EQ(__a.capacity(), __capacity);
+}
+
+int main() {
+	::testing::InitGoogleTest();
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+#include "thread_pool.h"
+#include <latch>
+
+using namespace network;
+
+TEST(thread_pool, runs_every_task) {
+	std::atomic<int> __sum = 0;
+	{
+		thread_pool __p{4};
+		for (int i = 1; i <= 1000; ++i)
+			__p.submit([&__sum, i] {
+				__sum += i;
+			});
+	}
+	EXPECT_EQ(__sum, 500500);
+}
+
+TEST(thread_pool, idle_workers_steal) {
+	thread_pool __p{4};
+	std::latch __done{64};
+	// submitted from one worker, so they all land in its deque
+	__p.submit([&] {
+		for (int i = 0; i < 64; ++i)
+			__p.submit([&] {
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				__done.count_down();
+			});
+	});
+	__done.wait();
+	EXPECT_GT(__p.steals(), 0);
+}
+
+TEST(thread_pool, deferred_tasks_run_last) {
+	thread_pool __p{1};
+	std::vector<int> __order;
+	std::latch __done{1};
+	__p.submit([&] {
+		__p.defer([&] {
+			__order.push_back(3);
+			__done.count_down();
+		});
+		__p.submit([&] { __order.push_back(1); });
+		__p.submit([&] { __order.push_back(2); });
+	});
+	__done.wait();
+	EXPECT_EQ(__order, (std::vector{2, 1, 3}));
+}
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include "tls/async.h"
+#include <array>
+#include <cstdio>
+#include <filesystem>
+
+using namespace network;
+using namespace network::tls;
+
+namespace {
+
+	/**
+	 * The tree has no TLS server, so the peer is `openssl s_server` with a throwaway certificate, echoing every line
+	 * reversed (-rev). Skipped where the openssl command line tool is missing.
+	 */
+	struct async_tls: testing::Test {
+
+		std::filesystem::path dir;
+
+		FILE* server = nullptr;
+
+		tcp_port_t port = 0;
+
+		void SetUp() override {
+			if (std::system("openssl version > /dev/null 2>&1"))
+				GTEST_SKIP() << "openssl is not available";
+			dir = std::filesystem::temp_directory_path() / std::format("network-test-tls-{}", getpid());
+			std::filesystem::create_directories(dir);
+			const auto __key = (dir / "key.pem").string(), __cert = (dir / "cert.pem").string();
+			ASSERT_EQ(std::system(std::format(
+				"openssl req -x509 -newkey ec -pkeyopt ec_paramgen_curve:prime256v1 -nodes -keyout {} -out {} -days 1 "
+				"-subj /CN=localhost > /dev/null 2>&1", __key, __cert).c_str()), 0);
+			server = popen(std::format(
+				"exec openssl s_server -accept 0 -cert {} -key {} -tls1_3 -rev -naccept 1 < /dev/null 2>&1",
+				__cert, __key).c_str(), "r");
+			ASSERT_TRUE(server);
+			// the port the system chose is announced as "ACCEPT [::]:port"
+			char __line[256];
+			while (std::fgets(__line, sizeof __line, server))
+				if (const std::string_view __l{__line}; __l.starts_with("ACCEPT")) {
+					port = std::stoi(std::string{__l.substr(__l.rfind(':') + 1)});
+					break;
+				}
+			ASSERT_NE(port, 0);
+		}
+
+		void TearDown() override {
+			if (server)
+				pclose(server);
+			if (!dir.empty())
+				std::filesystem::remove_all(dir);
+		}
+	};
+
+	task<byte_string> handshake_and_echo(tcp::reactor& loop, const tcp_port_t port) {
+		async_client __c{loop};
+		__c.session().add_cipher_suite({cipher_suite_t::AES_128_GCM_SHA256});
+		__c.session().add_group(named_group_t::x25519);
+		__c.session().key_share_cache = nullptr;
+		co_await __c.async_connect("localhost", port);
+		const byte_string __ping{reinterpret_cast<const std::uint8_t*>("ping\n")};
+		co_await __c.async_write(__ping);
+		byte_string __echo;
+		std::array<std::uint8_t, 256> __buffer;
+		while (!__echo.ends_with('\n')) {
+			const auto __n = co_await __c.async_read_some(__buffer);
+			if (!__n)
+				break;
+			__echo.append(__buffer.data(), __n);
+		}
+		co_await __c.async_close();
+		co_return __echo;
+	}
+}
+
+TEST_F(async_tls, handshake_and_echo) {
+	tcp::reactor __r;
+	EXPECT_EQ(tcp::block_on(__r, handshake_and_echo(__r, port)), (byte_string{'g', 'n', 'i', 'p', '\n'}));
+}
+
+TEST(async_tls_client, close_unconnected) {
+	tcp::reactor __r;
+	async_client __c{__r};
+	EXPECT_NO_THROW(tcp::block_on(__r, __c.async_close()));
+}
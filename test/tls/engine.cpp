@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include <array>
+#include "tls/engine.h"
+#include "tls-record/record.h"
+#include "tls-record/handshake.h"
+#include "tls-extension/extension.h"
+
+using namespace network::tls;
+
+TEST(record, parse_incomplete) {
+	std::unique_ptr<cipher_suite> suite;
+	traffic_secret_manager manager(network::endpoint_type::client, suite);
+	const byte_string __fragment{21, 3, 3, 0, 2, 1, 0, 22};
+	byte_string_view __v{__fragment.data(), 5};
+	EXPECT_FALSE(record::parse(__v, manager));
+	EXPECT_EQ(__v.size(), 5);
+	__v = __fragment;
+	const auto __record = record::parse(__v, manager);
+	ASSERT_TRUE(__record);
+	EXPECT_EQ(__record->type, content_type_t::alert);
+	EXPECT_EQ(__record->messages, (byte_string{1, 0}));
+	EXPECT_EQ(__v, (byte_string{22}));
+}
+
+TEST(record, seal_scattered) {
+	byte_string __payload(40000, 0);
+	for (std::size_t i = 0; i < __payload.size(); ++i)
+		__payload[i] = i * 7;
+	record __record{content_type_t::handshake, std::nullopt};
+	__record.messages = __payload;
+	const byte_string_view __v{__payload};
+	const std::array<byte_string_view, 3> __parts{__v.substr(0, 10), __v.substr(10, 20000), __v.substr(20010)};
+	const auto __sealed = __record.seal(__parts);
+	ASSERT_EQ(__sealed.size(), 3);
+	byte_string __joined;
+	for (const auto& __r: __sealed)
+		__joined += __r;
+	EXPECT_EQ(__joined, static_cast<byte_string>(__record));
+	EXPECT_EQ(__joined.size(), __payload.size() + 3 * 5);
+}
+
+TEST(engine, client_hello) {
+	engine __e;
+	__e.session().add_cipher_suite({cipher_suite_t::AES_128_GCM_SHA256});
+	__e.session().add_group(named_group_t::x25519);
+	EXPECT_FALSE(__e.want_write());
+	__e.start();
+	EXPECT_TRUE(__e.want_write());
+	EXPECT_TRUE(__e.want_read());
+	EXPECT_FALSE(__e.handshake_done());
+	const auto __out = __e.take_output();
+	ASSERT_GT(__out.size(), 5);
+	EXPECT_EQ(__out[0], static_cast<std::uint8_t>(content_type_t::handshake));
+	EXPECT_FALSE(__e.want_write());
+	// a partial record is buffered without blocking
+	__e.feed(byte_string{22, 3, 3});
+	EXPECT_FALSE(__e.handshake_done());
+	EXPECT_FALSE(__e.want_write());
+}
+
+TEST(engine, cached_key_share_group) {
+	group_cache cache;
+	engine __e;
+	__e.session().add_cipher_suite({cipher_suite_t::AES_128_GCM_SHA256});
+	__e.session().add_group(named_group_t::x25519);
+	__e.session().add_group(named_group_t::ffdhe2048);
+	__e.session().server_name = "cached.test";
+	__e.session().key_share_cache = &cache;
+
+	const auto shares = [&] {
+		__e.start();
+		const auto __out = __e.take_output();
+		byte_string_view __v{__out};
+		__v.remove_prefix(5);
+		const auto __msg = parse_handshake(__v, false, false);
+		return std::get<client_hello>(__msg.value()).get<key_share>(ext_type_t::key_share).shares.size();
+	};
+	EXPECT_EQ(shares(), 2);
+	cache.store("cached.test", named_group_t::ffdhe2048);
+	EXPECT_EQ(shares(), 1);
+}
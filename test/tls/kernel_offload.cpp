@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include "tls/endpoint.h"
+#include "tcp/client.h"
+#include "tcp/server.h"
+#include "tcp/unix_socket.h"
+
+using namespace network;
+using namespace network::tls;
+
+namespace {
+
+	struct memory_transport final: virtual string_stream, virtual stream_endpoint {
+
+		[[nodiscard]] bool connected() const override {
+			return true;
+		}
+
+		void finish() override {
+		}
+
+		void close() override {
+		}
+	};
+
+	/// Exposes the kernel offload steps, with traffic keys set by hand instead of by a handshake.
+	struct offload_endpoint final: endpoint {
+
+		offload_endpoint(stream_endpoint& base, const endpoint_type type,
+				const cipher_suite_t suite = cipher_suite_t::AES_128_GCM_SHA256)
+			: endpoint(base, type) {
+			use_cipher(suite);
+			const byte_string __key(16, 0x11), __iv(12, 0x22);
+			secret_.client_write_key = secret_.server_write_key = {__key, std::nullopt, std::endian::big};
+			secret_.client_write_iv = secret_.server_write_iv = {__iv, std::nullopt, std::endian::big};
+		}
+
+		using endpoint::offload_;
+		using endpoint::kernel_extract_;
+		using endpoint::kernel_send_;
+	};
+}
+
+TEST(kernel_offload, not_a_tcp_transport) {
+	memory_transport __s;
+	offload_endpoint __e{__s, endpoint_type::client};
+	EXPECT_FALSE(__e.offload_());
+	EXPECT_FALSE(__e.offloaded());
+}
+
+TEST(kernel_offload, ulp_rejected) {
+	// a unix socket is a tcp::endpoint to the code, but the kernel has no TLS ULP for it
+	unix_socket::server __server{"@network-test-kernel-offload"};
+	__server.listen(0, 1);
+	unix_socket::client __client;
+	__client.connect("@network-test-kernel-offload", 0);
+	const auto __accepted = __server.accept();
+	offload_endpoint __e{__client, endpoint_type::client};
+	EXPECT_FALSE(__e.offload_());
+	EXPECT_FALSE(__e.offloaded());
+	// records stay in userspace, so the connection is still usable as is
+	__client.write(byte_string_view{reinterpret_cast<const std::uint8_t*>("ok"), 2});
+	EXPECT_EQ(__accepted->read(2), (byte_string{'o', 'k'}));
+	__client.close();
+}
+
+TEST(kernel_offload, unsupported_suite) {
+	tcp::server __server;
+	__server.listen(0, 1);
+	tcp::client __client;
+	__client.connect("localhost", __server.local_port());
+	const auto __accepted = __server.accept();
+	offload_endpoint __e{__client, endpoint_type::client, cipher_suite_t::CHACHA20_POLY1305_SHA256};
+	EXPECT_FALSE(__e.offload_());
+	EXPECT_FALSE(__e.offloaded());
+	// no ULP was attached, so plain writes still reach the peer
+	__client.write(byte_string_view{reinterpret_cast<const std::uint8_t*>("ok"), 2});
+	EXPECT_EQ(__accepted->read(2), (byte_string{'o', 'k'}));
+	__client.close();
+}
+
+TEST(kernel_offload, record_types) {
+	tcp::server __server;
+	__server.listen(0, 1);
+	tcp::client __client;
+	__client.connect("localhost", __server.local_port());
+	const auto __accepted = __server.accept();
+	offload_endpoint __c{__client, endpoint_type::client};
+	offload_endpoint __s{*__accepted, endpoint_type::server};
+	if (!__c.offload_()) {
+		__client.close();
+		GTEST_SKIP() << "kernel TLS is not available";
+	}
+	ASSERT_TRUE(__s.offload_());
+
+	const byte_string __handshake{4, 0, 0, 0};
+	__c.kernel_send_(content_type_t::handshake, __handshake);
+	const auto __r1 = __s.kernel_extract_();
+	EXPECT_EQ(__r1.type, content_type_t::handshake);
+	EXPECT_EQ(__r1.messages, __handshake);
+
+	const byte_string __data{'p', 'i', 'n', 'g'};
+	__s.kernel_send_(content_type_t::application_data, __data);
+	const auto __r2 = __c.kernel_extract_();
+	EXPECT_EQ(__r2.type, content_type_t::application_data);
+	EXPECT_EQ(__r2.messages, __data);
+	__client.close();
+}
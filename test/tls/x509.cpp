@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include "tls/cert/trust_store.h"
+#include "tls-record/alert.h"
+#include "encoding/pem.h"
+#include "encoding/base64.h"
+
+using namespace network::tls;
+
+namespace {
+
+	constexpr std::string_view root_pem = R"(
+-----BEGIN CERTIFICATE-----
+MIIDITCCAgmgAwIBAgIUW9Bv16SNkFLF18yvoEfxGeZX6S0wDQYJKoZIhvcNAQEL
+BQAwFzEVMBMGA1UEAwwMVGVzdCBSb290IENBMCAXDTI2MTAxOTEzNDU0N1oYDzIx
+MjYwOTI1MTM0NTQ3WjAXMRUwEwYDVQQDDAxUZXN0IFJvb3QgQ0EwggEiMA0GCSqG
+SIb3DQEBAQUAA4IBDwAwggEKAoIBAQDXUjd1WTBY9FW+MILRAN0uEqqfW4GEtTtR
+Q/L1aYxjy4m6TOpV+gDwwux5YyCXfbuFxIFvWIaoG7dFtrEUXi7MVuXYPi+NFZZh
+VFnS6RpVwFfSObvty4PYHqJVEzkA2JIIA5mGB2R61GMK9wZY+AtMWTLppm4IBpmp
+5URsQU1PYNV76+m/Md9lAUa1kgGF0KHd+rgGtpenwLVBHR2MfZuLocs8WAz77Alw
+JOLsJQjHG3rXxN99zKRK9XgYkcQTeVe14mAxD7A8cB5u1Xlrsw1Ia33DMqw9yBGK
+oLerEsWXcvO2fTvFRGMnyLfgPsBxmsKgTW5TJUwSMXp7cjZnFTrlAgMBAAGjYzBh
+MB0GA1UdDgQWBBS5wANKGf9KI/MPO4VslYTbJLbYqTAfBgNVHSMEGDAWgBS5wANK
+Gf9KI/MPO4VslYTbJLbYqTAPBgNVHRMBAf8EBTADAQH/MA4GA1UdDwEB/wQEAwIB
+BjANBgkqhkiG9w0BAQsFAAOCAQEAkh/W3XwL4VEj8brcBR/Kitjw+31cb5xRTvtW
+T1JKroO8iO1XcA56/xkEmV5Ykh21t71SFbI1T+utUBGep1jBQVnN01JKJ6PeKmj+
+HfdFXXFljLQK189K/i11T1vLCjBfWiv3lKHdHgvXdduutfBwSvJxziM2AhUCd+R3
+P2gNZC+z1twWStJbsbb8LtkK+LH/XDUxx2P3XzqnoJLiqyYInN0zWybiEAVNZyGT
+QqocHz+eaYKEGmUBPHmi/UCt3BJRMX5cjymcnNl2ne0fw5g0Msz6CxqyhZSXPSIK
+Svi/uzTMscU2mlPmbOrNQSNNSkEIwInZVFlLNAzjfLq6st/qeg==
+-----END CERTIFICATE-----
+)";
+
+	constexpr std::string_view leaf_pem = R"(
+-----BEGIN CERTIFICATE-----
+MIIDNDCCAhygAwIBAgIUdM0Ef320yfqnhTZ3imjC5Ccwh2cwDQYJKoZIhvcNAQEL
+BQAwFzEVMBMGA1UEAwwMVGVzdCBSb290IENBMCAXDTI2MTAxOTEzNDU0N1oYDzIx
+MjYwOTI1MTM0NTQ3WjAXMRUwEwYDVQQDDAxleGFtcGxlLnRlc3QwggEiMA0GCSqG
+SIb3DQEBAQUAA4IBDwAwggEKAoIBAQCtDSlWpcOzYPgJfqx21U944bQIWu2V0u0M
+TxmXpIeuV1NYJLhEa7ttF7Ye5ne0TZSIewlK9/gk0hPaY/7Ep7u49GaU2fSmx+mb
+6n78SHsre5th6+IsJwt6mfu+gGgvBkN21LXZLri6j4Ip8wa4QIKyULosQAKbUJf3
+9j+RcJ4jtGBWb6aCl1h6ynr+S5+zS0F0tvo/WABaXuQUnpHh1OyiicdqYuTffxrQ
+ZA7Lw166w8VklJUR3JLO5TjAHOXOJrt8GEKiyGZxTXT2fDrmS1aWiv545nj+4wHd
+QI2wmqiCjrL5hWK2As9EPEefmn+d16LtFN7FWFv8S8SCj5uGZD/FAgMBAAGjdjB0
+MCcGA1UdEQQgMB6CDGV4YW1wbGUudGVzdIIOKi5leGFtcGxlLnRlc3QwCQYDVR0T
+BAIwADAdBgNVHQ4EFgQU3KDWOcDPUcsqnPB50dqb7gkgkAEwHwYDVR0jBBgwFoAU
+ucADShn/SiPzDzuFbJWE2yS22KkwDQYJKoZIhvcNAQELBQADggEBAKJfNnhEJoB6
+M2XGaR3Ggm+EAMGlyX9DtJ9UrTPVEoMtYhNyN34boJ7STQ5LCsfAPQZCoKsrGukb
+v81f3/mpGsVQNiq53lnBer/T0m6kc+Ws62Bd/9p1DILBjgmlB/OhRfZzpk95PfKc
+0WYAihjWyraFl9RxvfeAlc1CLkfdel+UkZbWMRllQOdZOGg2LbXDAsdTf9HsibxM
+O8/qjPxT5+oM5qNAxhpzj2KhoeTWgjgV9TJ65D/hLDF3yLmBiN2/0mpBuy0XFxDL
+vzcpBHqx/jkTFprBVb+9bR7TxR1b+P9S6Pnttfe8QZGWpYiOOTOgjXbU3nBqNkfr
+iTaMrWN7OEM=
+-----END CERTIFICATE-----
+)";
+
+	constexpr std::string_view ec_root_pem = R"(
+-----BEGIN CERTIFICATE-----
+MIIBljCCATugAwIBAgIUJrE41l5C+CPGOKz9Ll0whyHFTaowCgYIKoZIzj0EAwIw
+FzEVMBMGA1UEAwwMVGVzdCBFQyBSb290MCAXDTI2MTAxOTEzNTYwM1oYDzIxMjYw
+OTI1MTM1NjAzWjAXMRUwEwYDVQQDDAxUZXN0IEVDIFJvb3QwWTATBgcqhkjOPQIB
+BggqhkjOPQMBBwNCAAQ8IgFk07nJQ77BGefprDlNtlf6MvmEHZEASVxlmaZWf19A
+C+ipaZSYPSqSyfnC63HrFDRWKGFJoS5mvdWhkSp4o2MwYTAdBgNVHQ4EFgQUie9i
+Ad54R+VraEaSb4kPW75K1e0wHwYDVR0jBBgwFoAUie9iAd54R+VraEaSb4kPW75K
+1e0wDwYDVR0TAQH/BAUwAwEB/zAOBgNVHQ8BAf8EBAMCAgQwCgYIKoZIzj0EAwID
+SQAwRgIhAPJeqNWfi/ZuedjXWV7rXxTgSDP5V7EWQAGJN0BojXoEAiEAzLzLqZTH
+gdVIxg6Zn1X6SNEIo6HgTS+Hdf1dt8t1OCE=
+-----END CERTIFICATE-----
+)";
+
+	constexpr std::string_view ec_leaf_pem = R"(
+-----BEGIN CERTIFICATE-----
+MIIBhDCCASmgAwIBAgIUR0SEOTtx2hdn1eDgA6NSgR3TcsUwCgYIKoZIzj0EAwIw
+FzEVMBMGA1UEAwwMVGVzdCBFQyBSb290MCAXDTI2MTAxOTEzNTYwM1oYDzIxMjYw
+OTI1MTM1NjAzWjASMRAwDgYDVQQDDAdlYy50ZXN0MFkwEwYHKoZIzj0CAQYIKoZI
+zj0DAQcDQgAEK8qo0pD1tD85ZcdQPd2yBBSi7OVhIv64IrY/HppujwdOnRctYycl
+KbuhPquWDJ0/xyKkkn+FTauA3crndSsNNqNWMFQwEgYDVR0RBAswCYIHZWMudGVz
+dDAdBgNVHQ4EFgQUBYCkx4jjNFKYXfzJnM4J4TIJc8AwHwYDVR0jBBgwFoAUie9i
+Ad54R+VraEaSb4kPW75K1e0wCgYIKoZIzj0EAwIDSQAwRgIhAPpuT413nOW+Nlbm
+QkYXdqjCpUf8nV6Y3bH3Zx5leEcHAiEA75g+XY32slVZMOAoCKdUMBIdem5PhsOC
+Tf6vnaL7hyM=
+-----END CERTIFICATE-----
+)";
+
+	// "signed content" signed with the keys of the leaf certificates
+	constexpr std::string_view pss_sha256_b64 =
+		"lc07DPaZ37LmF15DJ/A/rVKsXF4+8tMetb94Uwy3QuuG2sI5NO5cd8+NFeRNsOcIXvobSuz7kicpGCh+2tE6QZcEKyWsr028U6/74gYcBjbquNRl"
+		"+8m7oBq5CWBQNckMaNHImP0d9cfFz7TUER4a6FUL+OlsA/vVdypAmvjenGcOaqtT49Buxg6H3ejpqxiWHmM1XGWuD4yWx4c/ySqJl0+/WPSnMLnP"
+		"S0nUwXsZPumhWytCN2QIwy4+5x9VN8CGfwGzq29rdNkQKMC0OcBPf1E1nfySfhMz0cBAzwgIUBRdG2WB/+XvFlif10xTJ8FLBeOCQU8Gvy1fROUq"
+		"ZWk1GQ==";
+
+	constexpr std::string_view ecdsa_sha256_b64 =
+		"MEUCIBGHTk+udG4zvyOi4/LS8TBua+DjyhApxEcinNJ4n4IeAiEAuiqoN5UNDpD8Yr4QBZZlx5WoOX3x2JRHngzVuC71Jok=";
+
+	const byte_string signed_message{reinterpret_cast<const std::uint8_t*>("signed content"), 14};
+
+	// all certificates are valid from 2026-10-19 until 2126-09-25
+	const auto now = std::chrono::sys_days{std::chrono::year{2030} / 1 / 1};
+}
+
+TEST(x509, parse) {
+	const x509::certificate __leaf{encoding::pem::from(leaf_pem.substr(1))};
+	EXPECT_EQ(__leaf.signature_algorithm, x509::oid::sha256_with_rsa);
+	EXPECT_EQ(__leaf.public_key.algorithm, x509::oid::rsa_encryption);
+	EXPECT_FALSE(__leaf.ca);
+	EXPECT_EQ(__leaf.dns_names, (std::list<std::string>{"example.test", "*.example.test"}));
+	EXPECT_EQ(__leaf.not_after, std::chrono::sys_days{std::chrono::year{2126} / 9 / 25} + std::chrono::seconds{13 * 3600 + 45 * 60 + 47});
+	EXPECT_TRUE(__leaf.matches_host("WWW.example.test"));
+	EXPECT_FALSE(__leaf.matches_host("a.b.example.test"));
+	EXPECT_FALSE(__leaf.matches_host("example.com"));
+}
+
+TEST(x509, verify_chain) {
+	x509::trust_store __store;
+	__store.add_pem(root_pem.substr(1));
+	ASSERT_EQ(__store.size(), 1);
+	const std::vector __chain{encoding::pem::from(leaf_pem.substr(1))};
+	EXPECT_EQ(__store.verify(__chain, "example.test", now).subject, x509::certificate{__chain.front()}.subject);
+	EXPECT_EQ(__store.cache().size(), 1);
+	// served from the cache on the second attempt
+	EXPECT_NO_THROW(__store.verify(__chain, "example.test", now));
+	EXPECT_THROW(__store.verify(__chain, "example.com", now), alert);
+	EXPECT_THROW(__store.verify(__chain, "example.test", std::chrono::sys_days{std::chrono::year{2200} / 1 / 1}), alert);
+
+	auto __tampered = __chain;
+	__tampered.front().back() ^= 1;
+	try {
+		__store.verify(__tampered, "example.test", now);
+		FAIL();
+	} catch (const alert& __a) {
+		EXPECT_EQ(__a.description, alert_description_t::unknown_ca);
+	}
+}
+
+TEST(x509, untrusted_root) {
+	x509::trust_store __store;
+	EXPECT_THROW(__store.verify({encoding::pem::from(leaf_pem.substr(1))}, "example.test", now), alert);
+	EXPECT_EQ(__store.cache().size(), 0);
+}
+
+TEST(x509, verify_ecdsa_chain) {
+	x509::trust_store __store;
+	__store.add_pem(ec_root_pem.substr(1));
+	const auto __leaf = __store.verify({encoding::pem::from(ec_leaf_pem.substr(1))}, "ec.test", now);
+	EXPECT_EQ(__leaf.public_key.parameters, x509::oid::prime256v1);
+}
+
+TEST(x509, certificate_verify_schemes) {
+	const x509::certificate __rsa{encoding::pem::from(leaf_pem.substr(1))}, __ec{encoding::pem::from(ec_leaf_pem.substr(1))};
+	auto __pss = encoding::base64::from(pss_sha256_b64), __ecdsa = encoding::base64::from(ecdsa_sha256_b64);
+	EXPECT_TRUE(x509::verify_signature(__rsa.public_key, signature_scheme_t::rsa_pss_rsae_sha256, signed_message, __pss));
+	EXPECT_TRUE(x509::verify_signature(__ec.public_key, signature_scheme_t::ecdsa_secp256r1_sha256, signed_message, __ecdsa));
+	EXPECT_FALSE(x509::verify_signature(__ec.public_key, signature_scheme_t::rsa_pss_rsae_sha256, signed_message, __pss));
+	__pss[10] ^= 1;
+	EXPECT_FALSE(x509::verify_signature(__rsa.public_key, signature_scheme_t::rsa_pss_rsae_sha256, signed_message, __pss));
+	auto __altered = signed_message;
+	__altered[0] ^= 1;
+	EXPECT_FALSE(x509::verify_signature(__ec.public_key, signature_scheme_t::ecdsa_secp256r1_sha256, __altered, __ecdsa));
+}
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include "tcp/unix_socket.h"
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+using namespace network;
+
+namespace {
+
+	void echo_once(unix_socket::server& s) {
+		s.listen(0, 4);
+		std::thread __t{[&] {
+			const auto __e = s.accept();
+			__e->write(__e->read(5));
+		}};
+		unix_socket::client __c;
+		__c.connect(s.path(), 0);
+		__c.cork(true);
+		__c.write(byte_string_view{reinterpret_cast<const std::uint8_t*>("hello"), 5});
+		__c.cork(false);
+		EXPECT_EQ(__c.read(5), reinterpret_cast<const std::uint8_t*>("hello"));
+		__t.join();
+	}
+}
+
+TEST(unix_socket, abstract_namespace) {
+	unix_socket::server __s{"@network-test-abstract"};
+	echo_once(__s);
+}
+
+TEST(unix_socket, filesystem_path) {
+	const auto __path = (std::filesystem::temp_directory_path() / "network-test.sock").string();
+	// a socket file left behind by a crashed server must not prevent binding
+	sockaddr_un __address;
+	const auto __length = unix_socket::make_address(__path, __address);
+	const int __stale = socket(AF_UNIX, SOCK_STREAM, 0);
+	ASSERT_EQ(::bind(__stale, reinterpret_cast<const sockaddr*>(&__address), __length), 0);
+	::close(__stale);
+	{
+		unix_socket::server __s{__path};
+		echo_once(__s);
+		EXPECT_TRUE(std::filesystem::exists(__path));
+	}
+	EXPECT_FALSE(std::filesystem::exists(__path));
+	// other files are left alone
+	std::ofstream{__path};
+	unix_socket::server __s{__path};
+	EXPECT_THROW(__s.listen(0, 4), std::runtime_error);
+	EXPECT_TRUE(std::filesystem::exists(__path));
+	std::filesystem::remove(__path);
+}
+
+TEST(unix_socket, live_socket_kept) {
+	const auto __path = (std::filesystem::temp_directory_path() / "network-test-live.sock").string();
+	unix_socket::server __running{__path};
+	__running.listen(0, 4);
+	// a second server must not take the path of one still running
+	unix_socket::server __second{__path};
+	EXPECT_THROW(__second.listen(0, 4), std::runtime_error);
+	unix_socket::client __c;
+	__c.connect(__path, 0);
+	const auto __e = __running.accept();
+	EXPECT_TRUE(__e->connected());
+	__c.close();
+}
+
+TEST(unix_socket, fixed_path_ignores_host) {
+	unix_socket::server __s{"@network-test-fixed"};
+	__s.listen(0, 4);
+	unix_socket::client __c{"@network-test-fixed"};
+	__c.connect("example.com", 80);
+	const auto __e = __s.accept();
+	__e->write(byte_string_view{reinterpret_cast<const std::uint8_t*>("ok"), 2});
+	__e->finish();
+	EXPECT_EQ(__c.read(2), reinterpret_cast<const std::uint8_t*>("ok"));
+	EXPECT_EQ(__c.available(), 0);
+	unix_socket::client __missing;
+	EXPECT_THROW(__missing.connect("@network-test-missing", 0), std::runtime_error);
+}
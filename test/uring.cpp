@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include "tcp/client.h"
+#include "tcp/server.h"
+#include "tcp/uring.h"
+
+using namespace network;
+
+TEST(uring, accept_recv_send) {
+	tcp::uring __u;
+	auto& __group = __u.add_buffer_group(1, 8, 64);
+	tcp::server __server;
+	__server.listen(0, 16);
+
+	std::vector<socket_t> __accepted;
+	__u.accept(__server.native_handle(), [&](const tcp::uring::completion& __c) {
+		if (__c.result == -ECANCELED)
+			return;
+		ASSERT_GE(__c.result, 0);
+		EXPECT_TRUE(__c.more());
+		__accepted.push_back(__c.result);
+	}, true);
+	__u.submit();
+
+	tcp::client __c1, __c2;
+	__c1.connect("localhost", __server.local_port());
+	__c2.connect("localhost", __server.local_port());
+	while (__accepted.size() < 2)
+		__u.run_once();
+
+	byte_string __received;
+	bool __closed = false;
+	__u.recv(__accepted[0], __group, [&](const tcp::uring::completion& __c) {
+		if (__c.result <= 0) {
+			__closed = true;
+			return;
+		}
+		ASSERT_TRUE(__c.buffer());
+		__received += __group.data(__c.buffer().value(), __c.result);
+		__group.recycle(__c.buffer().value());
+	}, true);
+	for (int i = 0; i < 20; ++i)
+		__c1.write(reinterpret_cast<const std::uint8_t*>("0123456789"));
+	while (__received.size() < 200)
+		__u.run_once();
+	EXPECT_EQ(__received.substr(190), reinterpret_cast<const std::uint8_t*>("0123456789"));
+
+	const byte_string __reply{'o', 'k'};
+	std::int32_t __sent = 0;
+	__u.send(__accepted[1], __reply, [&](const tcp::uring::completion& __c) {
+		__sent = __c.result;
+	});
+	__u.run_once();
+	EXPECT_EQ(__sent, 2);
+	EXPECT_EQ(__c2.read(2), __reply);
+
+	__c1.close();
+	while (!__closed)
+		__u.run_once();
+	__u.cancel(__server.native_handle());
+	while (__u.pending())
+		__u.run_once();
+	__c2.close();
+	for (const auto __s: __accepted)
+		::close(__s);
+}
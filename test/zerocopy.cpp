@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+#include "tcp/client.h"
+#include "tcp/server.h"
+#include <thread>
+
+using namespace network;
+
+TEST(zerocopy, completions_release_buffers) {
+	tcp::server __server;
+	__server.listen(0, 16);
+	tcp::client __c;
+	__c.connect("localhost", __server.local_port());
+	const auto __e = __server.accept();
+	if (!__c.zerocopy(true))
+		GTEST_SKIP() << "SO_ZEROCOPY not supported";
+
+	const auto __large = std::make_shared<const byte_string>(1 << 20, 'z');
+	const auto __small = std::make_shared<const byte_string>(16, 's');
+	std::thread __t{[&] {
+		__c.write_zerocopy(__large);
+		__c.write_zerocopy(__small);
+	}};
+	EXPECT_EQ(__e->read(__large->size()), *__large);
+	EXPECT_EQ(__e->read(__small->size()), *__small);
+	__t.join();
+	// the small buffer was copied, so only the large one is referenced until its completions arrive
+	EXPECT_EQ(__small.use_count(), 1);
+	for (int i = 0; i < 1000 && __c.zerocopy_pending(); ++i) {
+		__c.reap_zerocopy();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	EXPECT_EQ(__c.zerocopy_pending(), 0);
+	EXPECT_EQ(__large.use_count(), 1);
+	__c.close();
+}
+
+TEST(zerocopy, close_leaves_pending_sends_to_reaper) {
+	tcp::server __server;
+	__server.listen(0, 16);
+	tcp::client __c;
+	__c.connect("localhost", __server.local_port());
+	const auto __e = __server.accept();
+	if (!__c.zerocopy(true))
+		GTEST_SKIP() << "SO_ZEROCOPY not supported";
+
+	const auto __large = std::make_shared<const byte_string>(1 << 20, 'z');
+	std::thread __t{[&] {
+		__c.write_zerocopy(__large);
+		// nothing reaped yet: close() returns at once and leaves the completions to the reaper
+		__c.close();
+	}};
+	EXPECT_EQ(__e->read(__large->size()), *__large);
+	__t.join();
+	EXPECT_EQ(__c.zerocopy_pending(), 0);
+	EXPECT_FALSE(__c.connected());
+	// the reaper releases the buffer and closes the socket once the completions arrive
+	for (int i = 0; i < 2000 && (__large.use_count() > 1 || tcp::endpoint::zerocopy_lingering()); ++i)
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	EXPECT_EQ(__large.use_count(), 1);
+	EXPECT_EQ(tcp::endpoint::zerocopy_lingering(), 0);
+}